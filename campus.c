@@ -0,0 +1,168 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "campus.h"
+
+Campus *campus_create(int num_buildings, int num_workers, int lockstep, int tick_usec, const Sim_config *config)
+{
+    Campus *campus = (Campus *)malloc(sizeof(Campus));
+    Sim_config building_config = *config;
+    int i;
+
+    // 스레드 수를 정하지 않으면 코어 수 만큼(건물 수보다 많지 않게)
+    if (num_workers < 1)
+    {
+        num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (num_workers > num_buildings)
+    {
+        num_workers = num_buildings;
+    }
+
+    campus->num_buildings = num_buildings;
+    campus->num_workers = num_workers;
+    campus->lockstep = lockstep;
+    campus->tick_usec = tick_usec;
+    campus->paused = 0;
+    campus->quit = 0;
+    campus->step_paused = 0;
+    campus->step_quit = 0;
+    campus->workers = NULL;
+
+    campus->buildings = (Building **)malloc(sizeof(Building *) * num_buildings);
+    for (i = 0; i < num_buildings; i++)
+    {
+        building_config.id = i;
+        campus->buildings[i] = sim_create(&building_config);
+    }
+    return campus;
+}
+
+void campus_start(Campus *campus)
+{
+    Worker *worker;
+    int i;
+
+    pthread_barrier_init(&campus->barrier, NULL, campus->num_workers);
+    campus->workers = (pthread_t *)malloc(sizeof(pthread_t) * campus->num_workers);
+    for (i = 0; i < campus->num_workers; i++)
+    {
+        worker = (Worker *)malloc(sizeof(Worker));
+        worker->campus = campus;
+        worker->index = i;
+        if (pthread_create(&campus->workers[i], NULL, worker_f, (void *)worker) != 0)
+        {
+            perror("thread creation error: ");
+            exit(0);
+        }
+    }
+}
+
+void campus_stop(Campus *campus)
+{
+    int i;
+
+    campus->quit = 1;
+    for (i = 0; i < campus->num_workers; i++)
+    {
+        pthread_join(campus->workers[i], NULL);
+    }
+    free(campus->workers);
+    campus->workers = NULL;
+    pthread_barrier_destroy(&campus->barrier);
+}
+
+void campus_free(Campus *campus)
+{
+    int i;
+    for (i = campus->num_buildings - 1; i >= 0; i--)
+    {
+        sim_destroy(campus->buildings[i]);
+    }
+    free(campus->buildings);
+    free(campus);
+}
+
+void *worker_f(void *data)
+{
+    Worker *worker = (Worker *)data;
+    Campus *campus = worker->campus;
+    struct timespec next;
+    cpu_set_t cpus;
+    int quit, paused;
+    int i;
+
+    // 1. 맡은 코어에 스레드를 고정한다.
+    // 2. 맡은 건물(index, index + 스레드 수, ...)을 1초씩 진행한다.
+    // 2-1. lockstep 이면 모든 스레드가 틱마다 만나서 함께 진행한다.
+    // 3. 다음 틱 시각까지 기다린다.
+
+    CPU_ZERO(&cpus);
+    CPU_SET(worker->index % sysconf(_SC_NPROCESSORS_ONLN), &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (1)
+    {
+        if (campus->lockstep)
+        {
+            // 한 스레드가 대표로 상태를 읽어서 모두 같은 결정을 내린다
+            if (pthread_barrier_wait(&campus->barrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+            {
+                campus->step_quit = campus->quit;
+                campus->step_paused = campus->paused;
+            }
+            pthread_barrier_wait(&campus->barrier);
+            quit = campus->step_quit;
+            paused = campus->step_paused;
+        }
+        else
+        {
+            quit = campus->quit;
+            paused = campus->paused;
+        }
+
+        if (quit)
+        {
+            break;
+        }
+
+        if (!paused)
+        {
+            for (i = worker->index; i < campus->num_buildings; i += campus->num_workers)
+            {
+                sim_step(campus->buildings[i], 1);
+            }
+        }
+
+        worker_wait(campus, &next, paused);
+    }
+
+    free(worker);
+    return NULL;
+}
+
+void worker_wait(Campus *campus, struct timespec *next, int paused)
+{
+    if (campus->tick_usec == 0)
+    {
+        // 정지 중에는 쉬면서 기다린다
+        if (paused)
+        {
+            usleep(10000);
+        }
+        return;
+    }
+
+    next->tv_nsec += (long)campus->tick_usec * 1000;
+    while (next->tv_nsec >= 1000000000L)
+    {
+        next->tv_nsec -= 1000000000L;
+        next->tv_sec++;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, next, NULL);
+}
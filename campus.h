@@ -0,0 +1,38 @@
+#ifndef CAMPUS_H
+#define CAMPUS_H
+
+#include <pthread.h>
+#include <time.h>
+#include "elevator.h"
+
+/* 여러 건물을 함께 시뮬레이션한다.
+ * 건물은 스레드(코어)마다 나누어 맡고, 스레드는 코어에 고정된다. */
+typedef struct _CAMPUS
+{
+    Building **buildings;
+    int num_buildings;
+    int num_workers;            // 시뮬레이션 스레드 수
+    int lockstep;               // 1 : 모든 건물이 같은 틱을 함께 진행
+    int tick_usec;              // 1초(틱)의 실제 길이, 0이면 최대한 빠르게
+    volatile int paused;
+    volatile int quit;
+    int step_paused;            // lockstep 에서 이번 틱에 합의된 상태
+    int step_quit;
+    pthread_barrier_t barrier;
+    pthread_t *workers;
+} Campus;
+
+typedef struct _WORKER
+{
+    Campus *campus;
+    int index;
+} Worker;
+
+Campus *campus_create(int num_buildings, int num_workers, int lockstep, int tick_usec, const Sim_config *config);
+void campus_start(Campus *campus);
+void campus_stop(Campus *campus);
+void campus_free(Campus *campus);
+void *worker_f(void *data);
+void worker_wait(Campus *campus, struct timespec *next, int paused);
+
+#endif
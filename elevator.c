@@ -1,127 +1,153 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <termios.h>
-#include <limits.h>
-#include <math.h>
+#include "elevator.h"
+#include "campus.h"
+#include "server.h"
+#include "shm_export.h"
+#include "logger.h"
 
 #define QUIT 'Q'
 #define PAUSE 'W'
 #define RESUME 'E'
 #define RESTART 'R'
 #define CALL 'A'
-#define FLOOR 20
-#define NUM_ELEVATORS 6
-#define MAX_PEOPLE 15 // 엘리베이터 정원
-#define MAX_TOTAL 150 // 점검 받아야하는 수
-
-/* 요청 구조체 */
-typedef struct _REQUEST
-{
-    int start_floor; //현재층(요청이 이루어지는)
-    int dest_floor;  //목적층
-    int num_people;  //몇 명이 타는지
-} Request;
-
-typedef struct _FLOORNODE
-{
-    struct _FLOORNODE *prev;
-    struct _FLOORNODE *next;
-    int floor;  // -1 : 점검
-    int people; //+ 태운다, - 내린다
-} F_node;
-
-typedef struct _REQUESTNODE
-{
-    struct _REQUESTNODE *prev;
-    struct _REQUESTNODE *next;
-    Request req;
-} R_node;
-
-typedef struct _FLOORLIST
-{
-    F_node *head;
-    F_node *tail;
-} F_list;
-
-typedef struct _REQUESTLIST
-{
-    R_node *head;
-    R_node *tail;
-} R_list;
-
-/* 엘리베이터 구조체 */
-typedef struct _ELEVATOR
-{
-    int current_floor;
-    int next_dest;
-    int current_people;
-    int total_people;
-    int fix;
-    int fix_time;
-    F_list pending;
-} Elevator;
+#define LOG_LEVEL 'L'
+#define FLOOR SIM_FLOORS
+#define NUM_ELEVATORS SIM_ELEVATORS
+#define SOCKET_PATH "elevator.sock" // 호출 접수 소켓 파일
+#define RENDER_USEC 1000000 // 화면 갱신 주기
+#define LOG_PATH "elevator.log"     // 운행 일지 파일
 
 typedef struct _INPUT
 {
-    char *mode;
+    volatile char *mode; // 입력 스레드가 바꾸므로 매번 다시 읽는다
     int *req_current_floor;
     int *req_dest_floor;
     int *req_num_people;
+    int flag; // 키보드 호출이 입력되었는지
 } Input;
 
 typedef struct _SIMUL
 {
-    Elevator **elevators;
+    Campus *campus;
+    Building *building; // 화면에 보여주는 건물
     Input *input;
+    pthread_t server_thr;
+    int server_started; // 소켓 스레드가 돌고 있는지(종료할 때 기다린다)
 } Simul;
 
-/* 함수 헤더 */
-void init(Input **input, Simul **simul, Elevator *elevators[6]);
+void init(Input **input, Simul **simul, Campus *campus);
 void *input_f(void *data);
 void *simul_f(void *data);
-void print_UI(Elevator *elevators[6]);
-void print_elevator_info(Elevator *elevators[6]);
+void print_UI(const Sim_car cars[6]);
+void print_elevator_info(const Sim_car cars[6]);
 void print_menu(char mode, Input *input);
 void quit(Simul *simul);
-void simul_stop(char *mode);
+void simul_stop(volatile char *mode);
 void simul_restart(Simul *simul);
 void get_request(Input *input);
-void insert_into_queue(int current_floor, int dest_floor, int num_people);
-Elevator *find_elevator(Elevator *elevators[6], Request *current);
-F_node *find_ideal_location(Elevator *elevator, int start_floor, int dest_floor, int target);
-int find_time(F_list list, F_node *target, int start, int end);
-int find_min(int *arr, int n);
-void move_elevator(Elevator *elevators[6]);
-void fix_elevator(Elevator *elevator);
-void R_list_insert(R_list list, int current_floor, int dest_floor, int num_people);
-int R_list_size(R_list list);
-Request *R_list_remove(R_list list);
-void F_list_insert(F_list list, F_node *after, int floor, int people);
-int F_list_size(F_list list);
-void F_list_remove(F_list list);
-F_node *F_list_peek(F_list list);
-void print_F_list(F_list list);
-
-/* 전역 변수 */
-R_list reqs;
-int flag = 0;
-
-int main(void)
+void print_stats(const Sim_stats *stats);
+void print_stops(const Sim_car *car);
+
+int main(int argc, char *argv[])
 {
     Input *input;
     Simul *simul;
-    Elevator *elevators[6];
+    Campus *campus;
     pthread_t input_thr;
     pthread_t simul_thr;
     int tid_input;
     int tid_simul;
+    int tid_server;
+    int num_buildings = 1;
+    int num_workers = 0;
+    int lockstep = 1;
+    int tick_usec = 1000000;
+    int log_level = LOG_INFO;
+    int queue_capacity = 0;
+    int opt;
+    int i;
+    Sim_config config;
+    Log_ring **rings;
+
+    // -b 건물 수, -w 스레드 수, -i 건물마다 따로 진행, -t 1초(틱)의 길이(ms), -l 기록 수준, -q 요청 큐 크기
+    while ((opt = getopt(argc, argv, "b:w:it:l:q:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'b':
+            num_buildings = atoi(optarg);
+            break;
+        case 'w':
+            num_workers = atoi(optarg);
+            break;
+        case 'i':
+            lockstep = 0;
+            break;
+        case 't':
+            tick_usec = atoi(optarg) * 1000;
+            break;
+        case 'l':
+            log_level = atoi(optarg);
+            break;
+        case 'q':
+            queue_capacity = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-b buildings] [-w workers] [-i] [-t tick_ms] [-l log_level] [-q queue_capacity]\n", argv[0]);
+            exit(1);
+        }
+    }
+    if (num_buildings < 1)
+    {
+        num_buildings = 1;
+    }
 
     system("clear");
 
-    init(&input, &simul, elevators);
+    // 배정 결과는 소켓으로, 매 초 상태는 공유 메모리로 내보낸다
+    config.id = 0;
+    config.on_assign = server_assign;
+    config.on_tick = shm_publish;
+    config.ctx = NULL;
+    config.queue_capacity = queue_capacity;
+    config.queue_high_water = 0;
+    config.min_in_service = 0;
+    config.maint_tolerance = 0;
+    campus = campus_create(num_buildings, num_workers, lockstep, tick_usec, &config);
+    init(&input, &simul, campus);
+
+    // 소켓을 열지 못해도 키보드 호출로는 동작한다
+    if (server_init(SOCKET_PATH, campus) == 0)
+    {
+        tid_server = pthread_create(&simul->server_thr, NULL, server_f, NULL);
+        if (tid_server != 0)
+        {
+            perror("thread creation error: ");
+            exit(0);
+        }
+        simul->server_started = 1;
+    }
+
+    // 공유 메모리를 만들지 못해도 시뮬레이션은 동작한다
+    shm_init(num_buildings);
+
+    // 운행 일지는 건물마다 링 버퍼에 쌓이고 logger_f 가 파일에 쓴다
+    rings = (Log_ring **)malloc(sizeof(Log_ring *) * num_buildings);
+    for (i = 0; i < num_buildings; i++)
+    {
+        rings[i] = sim_log(campus->buildings[i]);
+    }
+    if (log_level < LOG_OFF || log_level > LOG_DEBUG)
+    {
+        log_level = LOG_INFO;
+    }
+    logger_start(LOG_PATH, rings, num_buildings, log_level);
+
+    campus_start(campus);
 
     tid_input = pthread_create(&input_thr, NULL, input_f, (void *)input);
     if (tid_input != 0)
@@ -143,57 +169,21 @@ int main(void)
     return 0;
 }
 
-void init(Input **input, Simul **simul, Elevator *elevators[6])
+void init(Input **input, Simul **simul, Campus *campus)
 {
-    int i, j;
-    reqs.head = (R_node *)malloc(sizeof(R_node));
-    reqs.tail = (R_node *)malloc(sizeof(R_node));
-    reqs.head->prev = NULL;
-    reqs.head->next = reqs.tail;
-    reqs.tail->prev = reqs.head;
-    reqs.tail->next = NULL;
-
     *input = (Input *)malloc(sizeof(Input));
     (*input)->mode = (char *)malloc(sizeof(char));
     (*input)->req_current_floor = (int *)malloc(sizeof(int));
     (*input)->req_dest_floor = (int *)malloc(sizeof(int));
     (*input)->req_num_people = (int *)malloc(sizeof(int));
+    *(*input)->mode = 0;
+    (*input)->flag = 0;
 
     *simul = (Simul *)malloc(sizeof(Simul));
     (*simul)->input = *input;
-
-    for (i = 0; i < NUM_ELEVATORS; i++)
-    {
-        elevators[i] = (Elevator *)malloc(sizeof(Elevator));
-    }
-
-    //엘리베이터 : 1, 2 - 저층, 3, 4 - 전층, 5, 6 - 고층
-    for (i = 0; i < NUM_ELEVATORS; i++)
-    {
-        elevators[i]->pending.head = (F_node *)malloc(sizeof(F_node));
-        elevators[i]->pending.tail = (F_node *)malloc(sizeof(F_node));
-        elevators[i]->pending.head->floor = 0;
-        elevators[i]->pending.tail->floor = 0;
-        elevators[i]->pending.head->prev = NULL;
-        elevators[i]->pending.head->next = elevators[i]->pending.tail;
-        elevators[i]->pending.tail->prev = elevators[i]->pending.head;
-        elevators[i]->pending.tail->next = NULL;
-
-        elevators[i]->current_floor = 1;
-        elevators[i]->next_dest = 1;
-        elevators[i]->current_people = 0;
-        elevators[i]->total_people = 0;
-        elevators[i]->fix = 0;
-        elevators[i]->fix_time = 0;
-    }
-
-    // 고층 엘리베이터는 처음 11층에 멈춰있음
-    elevators[4]->current_floor = 11;
-    elevators[4]->next_dest = 11;
-    elevators[5]->current_floor = 11;
-    elevators[5]->next_dest = 11;
-
-    (*simul)->elevators = elevators;
+    (*simul)->campus = campus;
+    (*simul)->building = campus->buildings[0];
+    (*simul)->server_started = 0;
 }
 
 void *input_f(void *data)
@@ -210,33 +200,37 @@ void *input_f(void *data)
         }
         else
         {
-            scanf(" %c", input->mode);
+            scanf(" %c", (char *)input->mode);
         }
     }
+    return NULL;
 }
 
 void *simul_f(void *data)
 {
-    int i;
     Simul *simul = (Simul *)data;
-    Elevator *response; // 요청에 응답하는 엘리베이터
-    F_node *location;   // 요청이 들어가는 위치
-    Request current;    // 처리할 요청
+    Building *building = simul->building;
+    const Sim_snapshot *snapshot;
+    Sim_call call;
 
     // 1. 화면을 출력한다.
     // 2. 특수 모드가 입력되면 실행한다
-    // 3. 엘리베이터 호출이 들어오면 호출에 응한다.
-    // 3-1. 응답할 엘리베이터를 선택한다.
-    // 3-2. 응답할 엘리베이터에 요청을 넣는다.
-    // 4. 엘리베이터를 이동시킨다.
+    // 3. 엘리베이터 호출이 들어오면 요청 큐에 넣는다.
+    // 엘리베이터는 시뮬레이션 스레드(worker_f)가 움직이고, 화면은 마지막 틱의 상태를 잠금 없이 읽는다.
 
     /* 반복문 1회 반복시 1초 소요 */
     while (1)
     {
+        snapshot = sim_snapshot(building);
         system("clear");
-        print_UI(simul->elevators);
+        if (simul->campus->num_buildings > 1)
+        {
+            printf("건물 %d / %d \n", snapshot->stats.id + 1, simul->campus->num_buildings);
+        }
+        print_UI(snapshot->cars);
         printf("\n");
-        print_elevator_info(simul->elevators);
+        print_elevator_info(snapshot->cars);
+        print_stats(&snapshot->stats);
         printf("\n");
         print_menu(*simul->input->mode, simul->input);
 
@@ -247,7 +241,9 @@ void *simul_f(void *data)
         }
         else if (*simul->input->mode == PAUSE)
         {
+            simul->campus->paused = 1;
             simul_stop(simul->input->mode);
+            simul->campus->paused = 0;
         }
         else if (*simul->input->mode == RESTART)
         {
@@ -258,43 +254,29 @@ void *simul_f(void *data)
         {
             get_request(simul->input);
         }
-
-        // 요청 큐에 추가 & 건물 정보 업데이트
-        insert_into_queue(*simul->input->req_current_floor, *simul->input->req_dest_floor, *simul->input->req_num_people);
-
-        //점검 필요한 엘리베이터 있으면 점검 요청 넣기(맨 마지막에)
-        for (i = 0; i < NUM_ELEVATORS; i++)
+        else if (*simul->input->mode == LOG_LEVEL)
         {
-            if (simul->elevators[i]->total_people >= MAX_TOTAL)
-            {
-                F_list_insert(simul->elevators[i]->pending, simul->elevators[i]->pending.tail, -1, 0);
-                simul->elevators[i]->total_people = 0;
-            }
+            // 끔 -> 기본 -> 상세 -> 끔
+            logger_set_level((logger_level() + 1) % (LOG_DEBUG + 1));
+            *simul->input->mode = 0;
         }
 
-        if (R_list_size(reqs) != 0)
+        // 요청 큐에 추가
+        if (simul->input->flag)
         {
-            current = *R_list_remove(reqs);
-            response = find_elevator(simul->elevators, &current);
-            // 요청에 응답하는 엘리베이터에 정보 추가하기
-
-            // 사람 태울 층 추가하기
-            location = find_ideal_location(response, current.start_floor, current.dest_floor, current.start_floor);
-            F_list_insert(response->pending, location, current.start_floor, current.num_people);
-
-            // 사람 내릴 층 추가하기
-            location = find_ideal_location(response, current.start_floor, current.dest_floor, current.dest_floor);
-            F_list_insert(response->pending, location, current.dest_floor, current.num_people * -1);
+            call.start_floor = *simul->input->req_current_floor;
+            call.dest_floor = *simul->input->req_dest_floor;
+            call.num_people = *simul->input->req_num_people;
+            call.tag = 0;
+            sim_submit(building, &call, NULL);
+            simul->input->flag = 0;
         }
 
-        // 엘리베이터 이동시키기
-        move_elevator(simul->elevators);
-
-        sleep(1);
+        usleep(RENDER_USEC);
     }
 }
 
-void print_UI(Elevator *elevators[6])
+void print_UI(const Sim_car cars[6])
 {
     int i, j;
     for (i = 0; i < FLOOR; i++)
@@ -303,28 +285,28 @@ void print_UI(Elevator *elevators[6])
         printf("%2dF ", FLOOR - i);
         for (j = 0; j < NUM_ELEVATORS; j++)
         {
-            if (elevators[j]->current_floor == FLOOR - i)
+            if (cars[j].current_floor == FLOOR - i)
             {
                 printf("|");
-                if (elevators[j]->fix)
+                if (cars[j].fix)
                 {
                     printf(" 수리중");
                 }
-                else if (elevators[j]->current_floor == elevators[j]->next_dest)
+                else if (cars[j].current_floor == cars[j].next_dest)
                 {
-                    printf("   %2dF ", elevators[j]->next_dest);
+                    printf("   %2dF ", cars[j].next_dest);
                 }
-                else if (elevators[j]->current_floor > elevators[j]->next_dest)
+                else if (cars[j].current_floor > cars[j].next_dest)
                 {
                     printf(" ▼");
-                    printf(" %2dF ", elevators[j]->next_dest);
+                    printf(" %2dF ", cars[j].next_dest);
                 }
                 else
                 {
                     printf("▲ ");
-                    printf(" %2dF ", elevators[j]->next_dest);
+                    printf(" %2dF ", cars[j].next_dest);
                 }
-                printf("%2d명", elevators[j]->current_people);
+                printf("%2d명", cars[j].current_people);
             }
             else
             {
@@ -339,19 +321,23 @@ void print_UI(Elevator *elevators[6])
     printf("       저층용 1    저층용 2    전층용 1    전층용 2    고층용 1    고층용 2 \n");
 }
 
-void print_elevator_info(Elevator *elevators[6])
+void print_elevator_info(const Sim_car cars[6])
 {
     int i;
     for (i = 0; i < NUM_ELEVATORS; i++)
     {
         printf("엘리베이터 %d | ", i + 1);
-        if (elevators[i]->fix)
+        if (cars[i].fix)
         {
             printf("수리 중 | ");
-            printf("남은 시간 : %d초 \n", 30 - elevators[i]->fix_time);
+            printf("남은 시간 : %d초 \n", cars[i].fix_remaining);
             continue;
         }
-        else if (elevators[i]->current_floor == elevators[i]->next_dest)
+        else if (cars[i].dwell > 0)
+        {
+            printf("승하차 중 | ");
+        }
+        else if (cars[i].current_floor == cars[i].next_dest)
         {
             printf("대기 중 | ");
         }
@@ -359,10 +345,10 @@ void print_elevator_info(Elevator *elevators[6])
         {
             printf("운행 중 | ");
         }
-        printf("%2d명 탑승 중 | ", elevators[i]->current_people);
-        printf("총 %3d명 탑승 | ", elevators[i]->total_people);
+        printf("%2d명 탑승 중 | ", cars[i].current_people);
+        printf("총 %3d명 탑승 | ", cars[i].total_people);
         printf("대기 요청 : ");
-        print_F_list(elevators[i]->pending);
+        print_stops(&cars[i]);
         printf("\n");
     }
 }
@@ -373,7 +359,8 @@ void print_menu(char mode, Input *input)
     printf("W : 정지\t");
     printf("E : 재개\t");
     printf("R : 재시작\t");
-    printf("A : 호출\n");
+    printf("A : 호출\t");
+    printf("L : 기록 수준(%s)\n", logger_level() == LOG_OFF ? "끔" : logger_level() == LOG_INFO ? "기본" : "상세");
     printf("메뉴 선택 : ");
 
     fflush(stdout);
@@ -381,27 +368,35 @@ void print_menu(char mode, Input *input)
 
 void quit(Simul *simul)
 {
-    R_node *curr, *temp;
+    Campus *campus = simul->campus;
+    Sim_stats stats;
+    long total_ticks = 0;
     int i;
-    printf("\n엘리베이터 시뮬레이션 시스템을 종료합니다. \n");
-    for (i = NUM_ELEVATORS - 1; i >= 0; i--)
+    printf("\n");
+    sim_stats(simul->building, &stats);
+    print_stats(&stats);
+    campus_stop(campus);
+    if (campus->num_buildings > 1)
     {
-        free(simul->elevators[i]->pending.tail);
-        free(simul->elevators[i]->pending.head);
+        for (i = 0; i < campus->num_buildings; i++)
+        {
+            total_ticks += sim_ticks(campus->buildings[i]);
+        }
+        printf("건물 %d개 | 총 %ld초 진행 \n", campus->num_buildings, total_ticks);
     }
+    printf("엘리베이터 시뮬레이션 시스템을 종료합니다. \n");
 
-    for (i = NUM_ELEVATORS - 1; i >= 0; i--)
+    // 건물을 지우기 전에 소켓 스레드가 호출을 더 넣지 않도록 끝날 때 까지 기다린다
+    if (simul->server_started)
     {
-        free(simul->elevators[i]);
+        server_stop();
+        pthread_join(simul->server_thr, NULL);
     }
+    server_close();
+    shm_close();
+    logger_stop();
 
-    curr = reqs.head;
-    while(curr != NULL)
-    {
-        temp = curr;
-        curr = curr->next;
-        free(temp);
-    }
+    campus_free(campus);
 
     free(simul->input->req_current_floor);
     free(simul->input->req_dest_floor);
@@ -412,7 +407,7 @@ void quit(Simul *simul)
     exit(0);
 }
 
-void simul_stop(char *mode)
+void simul_stop(volatile char *mode)
 {
     while (*mode != RESUME && *mode != QUIT && *mode != RESTART)
     {
@@ -421,39 +416,14 @@ void simul_stop(char *mode)
 
 void simul_restart(Simul *simul)
 {
-    R_node *curr, *temp;
     int i;
-    for (i = 0; i < NUM_ELEVATORS; i++)
+
+    for (i = 0; i < simul->campus->num_buildings; i++)
     {
-        simul->elevators[i]->current_floor = 1;
-        simul->elevators[i]->next_dest = 1;
-        simul->elevators[i]->current_people = 0;
-        simul->elevators[i]->total_people = 0;
-        simul->elevators[i]->fix = 0;
-        simul->elevators[i]->pending.head->prev = NULL;
-        simul->elevators[i]->pending.head->next = simul->elevators[i]->pending.tail;
-        simul->elevators[i]->pending.tail->prev = simul->elevators[i]->pending.head;
-        simul->elevators[i]->pending.tail->next = NULL;
+        sim_reset(simul->campus->buildings[i]);
     }
 
-    // 고층 엘리베이터는 시작 층이 11층
-    simul->elevators[4]->current_floor = 11;
-    simul->elevators[4]->next_dest = 11;
-    simul->elevators[5]->current_floor = 11;
-    simul->elevators[5]->next_dest = 11;
-
     *simul->input->mode = 0;
-
-    //요청 목록 초기화
-    curr = reqs.head->next;
-    while(curr != reqs.tail)
-    {
-        temp = curr;
-        curr = curr->next;
-        free(temp);
-    }
-    reqs.head->next = reqs.tail;
-    reqs.tail->prev = reqs.head;
 }
 
 void get_request(Input *input)
@@ -466,526 +436,28 @@ void get_request(Input *input)
         scanf("%d %d %d", input->req_current_floor, input->req_dest_floor, input->req_num_people);
         tcflush(0, TCIFLUSH);
         *input->mode = 0;
-        flag = 1;
+        input->flag = 1;
         break;
     }
 }
 
-void insert_into_queue(int current_floor, int dest_floor, int num_people)
-{
-    if (flag == 0)
-    {
-        return;
-    }
-
-    if (current_floor == dest_floor)
-    {
-        return;
-    }
-
-    if (current_floor > FLOOR || current_floor < 1 || dest_floor > FLOOR || dest_floor < 1)
-    {
-        return;
-    }
-
-    R_list_insert(reqs, current_floor, dest_floor, num_people);
-
-    flag = 0;
-}
-
-Elevator *find_elevator(Elevator *elevators[6], Request *current)
-{
-    F_node **ideal;
-    int *time_required;
-    int ideal_index;
-    int i;
-    int size;
-    int s = 0;
-
-    // 1. 큐에 요청을 뺀다
-    // 2. 각각에 가상의 스케쥴링을 실행한다
-    // 2-1. 점검 요청이 들어와 있으면 소요시간을 최대로 한다
-    // 2-2. 엘리베이터가 만원인 경우에도 소요시간을 최대로 한다
-    // 3. 각각의 소요시간을 구한다
-    // 4. 최소 시간 걸리는 엘리베이터 리턴
-
-    printf("\n"); // 출력 줄맞춤 위함
-
-    if ((current->start_floor > 10 && current->dest_floor <= 10) || (current->start_floor <= 10 && current->dest_floor > 10))
-    {
-        s = 2;
-        size = 2;
-        ideal = (F_node **)malloc(sizeof(F_node *) * size);
-        time_required = (int *)malloc(sizeof(int) * size);
-        for (i = 0; i < 2; i++)
-        {
-            if (elevators[i + s]->pending.tail->prev->floor == -1 || elevators[i + s]->fix == 1)
-            {
-                time_required[i] = INT_MAX;
-                continue;
-            }
-            if (elevators[i + s]->current_people == MAX_PEOPLE)
-            {
-                ideal[i] = NULL;
-                time_required[i] = INT_MAX;
-                continue;
-            }
-            ideal[i] = find_ideal_location(elevators[i + s], current->start_floor, current->dest_floor, current->start_floor);
-            time_required[i] = find_time(elevators[i + s]->pending, ideal[i], elevators[i + s]->current_floor, current->start_floor);
-            printf("%d번째 엘리베이터 소요시간: %d초 \n", i + s + 1, time_required[i]);
-        }
-    }
-    else if (current->start_floor > 10 || current->dest_floor > 10)
-    {
-        s = 2;
-        size = 4;
-        ideal = (F_node **)malloc(sizeof(F_node *) * size);
-        time_required = (int *)malloc(sizeof(int) * size);
-        for (i = 0; i < 4; i++)
-        {
-            if (elevators[i + s]->pending.tail->prev->floor == -1 || elevators[i + s]->fix == 1)
-            {
-                time_required[i] = INT_MAX;
-                continue;
-            }
-            if (elevators[i + s]->current_people == MAX_PEOPLE)
-            {
-                ideal[i] = NULL;
-                time_required[i] = INT_MAX;
-                continue;
-            }
-            ideal[i] = find_ideal_location(elevators[i + s], current->start_floor, current->dest_floor, current->start_floor);
-            time_required[i] = find_time(elevators[i + s]->pending, ideal[i], elevators[i + s]->current_floor, current->start_floor);
-            printf("%d번째 엘리베이터 소요시간: %d초 \n", i + s + 1, time_required[i]);
-        }
-    }
-    else
-    {
-        size = 4;
-        ideal = (F_node **)malloc(sizeof(F_node *) * size);
-        time_required = (int *)malloc(sizeof(int) * size);
-        for (i = 0; i < 4; i++)
-        {
-            if (elevators[i + s]->pending.tail->prev->floor == -1 || elevators[i + s]->fix == 1)
-            {
-                time_required[i] = INT_MAX;
-                continue;
-            }
-            if (elevators[i + s]->current_people == MAX_PEOPLE)
-            {
-                ideal[i] = NULL;
-                time_required[i] = INT_MAX;
-                continue;
-            }
-            ideal[i] = find_ideal_location(elevators[i + s], current->start_floor, current->dest_floor, current->start_floor);
-            time_required[i] = find_time(elevators[i + s]->pending, ideal[i], elevators[i + s]->current_floor, current->start_floor);
-            printf("%d번째 엘리베이터 소요시간: %d초 \n", i + s + 1, time_required[i]);
-        }
-    }
-
-    ideal_index = find_min(time_required, size);
-    free(time_required);
-    free(ideal);
-
-    printf("엘리베이터 %d 호출에 응답 \n", ideal_index + s + 1);
-    return elevators[ideal_index + s];
-}
-
-F_node *find_scheduled_place(F_node *start, F_node *end, int start_floor, int dest_floor, int target)
-{
-    F_node *current = start;
-    int call_direction = dest_floor - start_floor;
-    if (call_direction > 0)
-    {
-        while (1)
-        {
-            if(current->next == NULL)
-            {
-                return current;
-            }
-            if(current == end->next)
-            {
-                return current;
-            }
-            if(target < current->floor)
-            {
-                return current;
-            }
-            current = current->next;
-        }
-    }
-    else
-    {
-        while (1)
-        {
-            if(current->next == NULL)
-            {
-                return current;
-            }
-            if(current == end->next)
-            {
-                return current;
-            }
-            if(target > current->floor)
-            {
-                return current;
-            }
-            current = current->next;
-        }
-    }
-}
-
-F_node *find_direction_change_location(F_node *current, int current_direction)
-{
-    int new_direction;
-    F_node *target = current;
-
-    while (1)
-    {
-        if(target->next == NULL)
-        {
-            return target;
-        }
-        else if(target->next->next == NULL)
-        {
-            return target->next;
-        }
-
-        new_direction = target->next->floor - target->floor;
-        if(new_direction * current_direction < 0)
-        {
-            return target;
-        }
-
-        target = target->next;
-    }
-}
-
-F_node *find_ideal_location(Elevator *elevator, int start_floor, int dest_floor, int target)
-{
-    int elevator_direction = 0;
-    int call_direction = 0;
-    F_list list = elevator->pending;
-    F_node *start = list.head->next;
-    F_node *end;
-
-    if (F_list_size(list) == 0)
-    {
-        return start;
-    }
-
-    elevator_direction = start->floor - elevator->current_floor;
-    if(elevator_direction == 0)
-    {
-        if(F_list_size(list) == 1)
-        {
-            return start->next;
-        }
-        else
-        {
-            elevator_direction = start->next->floor - start->floor;
-        }
-    }
-
-    call_direction = dest_floor - start_floor;
-
-    if (call_direction > 0)
-    {
-        if (elevator_direction > 0)
-        {
-            if (target >= elevator->current_floor)
-            {
-                end = find_direction_change_location(start, elevator_direction);
-                return find_scheduled_place(start, end, start_floor, dest_floor, target);
-            }
-            else
-            {
-                // 다음 방향 같아질 때 까지 찾아야 함!
-                start = find_direction_change_location(start, elevator_direction);
-                elevator_direction *= -1;
-                start = find_direction_change_location(start, elevator_direction);
-                elevator_direction *= -1;
-                end = find_direction_change_location(start, elevator_direction);
-                return find_scheduled_place(start, end, start_floor, dest_floor, target);
-            }
-        }
-        else
-        {
-            // 다음 방향 바뀔 때 까지 찾아야 함!
-            start = find_direction_change_location(start, elevator_direction);
-            elevator_direction *= -1;
-            end = find_direction_change_location(start, elevator_direction);
-            return find_scheduled_place(start, end, start_floor, dest_floor, target);
-        }
-    }
-    else
-    {
-        if (elevator_direction < 0)
-        {
-            if (target <= elevator->current_floor)
-            {
-                end = find_direction_change_location(start, elevator_direction);
-                return find_scheduled_place(start, end, start_floor, dest_floor, target);
-            }
-            else
-            {
-                // 다음 방향 같아질 때 까지 찾아야 함!
-                start = find_direction_change_location(start, elevator_direction);
-                elevator_direction *= -1;
-                start = find_direction_change_location(start, elevator_direction);
-                elevator_direction *= -1;
-                end = find_direction_change_location(start, elevator_direction);
-                return find_scheduled_place(start, end, start_floor, dest_floor, target);
-            }
-        }
-        else
-        {
-            // 다음 방향 바뀔 때 까지 찾아야 함!
-            start = find_direction_change_location(start, elevator_direction);
-            elevator_direction *= -1;
-            end = find_direction_change_location(start, elevator_direction);
-            return find_scheduled_place(start, end, start_floor, dest_floor, target);
-        }
-    }
-}
-
-int find_time(F_list list, F_node *target, int start, int end)
-{
-    int time = 0;
-    F_node *curr = list.head->next;
-
-    if(curr == target)
-    {
-        time += abs(end - start);
-        return time;
-    }
-
-    if (curr->next == NULL)
-    {
-        time += abs(end - start);
-        return time;
-    }
-
-    time += abs(curr->floor - start);
-    time++;
-
-    while (curr->next != target)
-    {
-        time += abs(curr->next->floor - curr->floor);
-        time++;
-        curr = curr->next;
-    }
-    time += abs(end - curr->floor);
-    return time;
-}
-
-int find_min(int *arr, int n)
+void print_stats(const Sim_stats *stats)
 {
-    // 우선순위 규칙
-    // 1. 시간이 최소로 걸리는 엘리베이터
-    // 2. 운행 범위가 좁은 엘리베이터(저층 > 전층)
-    // 3. 현재 사람 수가 적은 엘리베이터(이미 만원인 엘리베이터는 제외)
-    // 4. 인덱스가 적은 엘리베이터
-
-    int i;
-    int min = 0;
-    for (i = 1; i < n; i++)
-    {
-        if (arr[i] < arr[min])
-        {
-            min = i;
-        }
-    }
-    //추가 우선순위에 대한 고려 필요
-    return min;
+    printf("대기 시간 평균 %d초 | p50 %d초 | p95 %d초 | p99 %d초 | ", stats->wait_average, stats->wait_p50, stats->wait_p95, stats->wait_p99);
+    printf("점검 앞당김 %d회 | 미룸 %d회 | 강제 %d회 | 재배정 %d회 \n", stats->maint_advanced, stats->maint_deferred, stats->maint_forced, stats->rebalanced);
+    printf("요청 큐 %d건(최대 %d건) | 태우지 않은 호출 %d건 | 배정까지 평균 %d초 | p95 %d초 | p99 %d초 | 거절 %d건 \n", stats->queue_depth, stats->queue_peak, stats->backlog, stats->queue_delay_average, stats->queue_delay_p95, stats->queue_delay_p99, stats->shed);
 }
 
-void move_elevator(Elevator *elevators[6])
+void print_stops(const Sim_car *car)
 {
     int i;
-    int to_ride = 0; // 태워야 할 사람 수
-    int available;   // 정원이 초과될 시 최대로 태울수 있는 사람 수
-    int leftover;    // 못 타고 남아있는 사람 수
-    F_node *next_floor;
-    F_node *pair;
-
-    // 1. 다음 목적지를 구한다(있으면).
-    // 1-1. 수리 요청인 경우 수리에 들어간다.
-    // 2. 현재 층과 비교하여,
-    // 3. 높으면 현재층 증가, 낮으면 감소, 같으면 사람을 태운다.
-    // 4. 사람을 다 못 태우면 최대 수용 가능 인원만 태운다.
-    // 4-1. 다 못 타고 남은 인원은 다시 엘리베이터를 호출한다.
-
-    for (i = 0; i < NUM_ELEVATORS; i++)
+    for (i = 0; i < car->num_stops && i < SIM_MAX_STOPS; i++)
     {
-        if (elevators[i]->fix)
-        {
-            fix_elevator(elevators[i]);
-            continue;
-        }
-
-        if (F_list_size(elevators[i]->pending) > 0)
-        {
-            next_floor = F_list_peek(elevators[i]->pending);
-            if (next_floor->floor == -1)
-            {
-                elevators[i]->fix = 1;
-                F_list_remove(elevators[i]->pending);
-            }
-            else
-            {
-                if (elevators[i]->next_dest != next_floor->floor)
-                {
-                    elevators[i]->next_dest = next_floor->floor;
-                }
-
-                if (elevators[i]->next_dest > elevators[i]->current_floor)
-                {
-                    (elevators[i]->current_floor)++;
-                }
-                else if (elevators[i]->next_dest < elevators[i]->current_floor)
-                {
-                    (elevators[i]->current_floor)--;
-                }
-                else
-                {
-                    if (elevators[i]->current_floor == next_floor->floor)
-                    {
-                        available = MAX_PEOPLE - elevators[i]->current_people;
-                        if (next_floor->people <= available)
-                        {
-                            elevators[i]->current_people += next_floor->people;
-                            if (next_floor->people > 0)
-                            {
-                                elevators[i]->total_people += next_floor->people;
-                            }
-                            F_list_remove(elevators[i]->pending);
-                        }
-                        else
-                        {
-                            elevators[i]->current_people += available;
-                            elevators[i]->total_people += available;
-                            leftover = next_floor->people - available;
-                            pair = next_floor->next;
-                            while (1)
-                            {
-                                if (next_floor->people + pair->people == 0)
-                                {
-                                    break;
-                                }
-                                pair = pair->next;
-                            }
-                            F_list_remove(elevators[i]->pending);
-
-                            pair->people = available * -1;
-
-                            flag = 1;
-                            insert_into_queue(elevators[i]->current_floor, pair->floor, leftover);
-                        }
-                    }
-                }
-            }
-        }
+        printf("(%dF %d명) ", car->stops[i].floor, car->stops[i].people);
     }
-}
-
-void fix_elevator(Elevator *elevator)
-{
-    (elevator->fix_time)++;
-    if (elevator->fix_time == 30)
+    if (car->num_stops > SIM_MAX_STOPS)
     {
-        elevator->fix = 0;
-        elevator->fix_time = 0;
+        printf("... ");
     }
 }
 
-void R_list_insert(R_list list, int current_floor, int dest_floor, int num_people)
-{
-    R_node *new_node = (R_node *)malloc(sizeof(R_node));
-    new_node->next = list.tail;
-    new_node->prev = new_node->next->prev;
-    new_node->prev->next = new_node;
-    new_node->next->prev = new_node;
-    new_node->req.start_floor = current_floor;
-    new_node->req.dest_floor = dest_floor;
-    new_node->req.num_people = num_people;
-}
-
-int R_list_size(R_list list)
-{
-    int size = 0;
-    R_node *curr = list.head->next;
-    while (curr != list.tail)
-    {
-        size++;
-        curr = curr->next;
-    }
-
-    return size;
-}
-
-Request *R_list_remove(R_list list)
-{
-    R_node *to_remove = list.head->next;
-    Request *ret = &to_remove->req;
-
-    to_remove->prev->next = to_remove->next;
-    to_remove->next->prev = to_remove->prev;
-    to_remove->next = NULL;
-    to_remove->prev = NULL;
-
-    free(to_remove);
-    return ret;
-}
-
-void F_list_insert(F_list list, F_node *after, int floor, int people)
-{
-    F_node *new_node = (F_node *)malloc(sizeof(F_node));
-    new_node->next = after;
-    new_node->prev = new_node->next->prev;
-    new_node->next->prev = new_node;
-    new_node->prev->next = new_node;
-    new_node->floor = floor;
-    new_node->people = people;
-}
-
-int F_list_size(F_list list)
-{
-    F_node *curr = list.head->next;
-    int num = 0;
-
-    while (curr != list.tail)
-    {
-        num++;
-        curr = curr->next;
-    }
-
-    return num;
-}
-
-void F_list_remove(F_list list)
-{
-    F_node *to_remove = list.head->next;
-
-    to_remove->prev->next = to_remove->next;
-    to_remove->next->prev = to_remove->prev;
-    to_remove->next = NULL;
-    to_remove->prev = NULL;
-
-    free(to_remove);
-}
-
-F_node *F_list_peek(F_list list)
-{
-    return list.head->next;
-}
-
-void print_F_list(F_list list)
-{
-    F_node *curr = list.head->next;
-    while (curr != list.tail)
-    {
-        printf("(%dF %d명) ", curr->floor, curr->people);
-        curr = curr->next;
-    }
-}
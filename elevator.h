@@ -0,0 +1,139 @@
+#ifndef ELEVATOR_H
+#define ELEVATOR_H
+
+/* 엘리베이터 시뮬레이션 라이브러리(libelevator.a)
+ *
+ * 건물 하나의 시뮬레이션을 만들고, 호출을 넣고, 원하는 만큼 진행시키고,
+ * 엘리베이터 상태와 운행 통계를 읽어온다.
+ * 라이브러리는 화면, 파일 입출력을 하지 않고 전역 변수를 쓰지 않는다.
+ * 호출 넣기와 상태 읽기는 진행 중인 다른 스레드에서 해도 된다.
+ * 상태는 매 틱 끝에 통째로 복사해 세 칸짜리 버퍼로 내보내므로, 읽는 쪽은 잠금 없이
+ * 한 틱의 상태를 온전히 읽고 진행을 기다리게 하지 않는다. */
+
+#include <stdint.h>
+#include "elevator_log.h"
+
+#define SIM_FLOORS 20     // 1층 ~ 20층
+#define SIM_ELEVATORS 6   // 1, 2 - 저층, 3, 4 - 전층, 5, 6 - 고층
+#define SIM_MAX_PEOPLE 15 // 엘리베이터 정원
+#define SIM_MAX_WAIT 300  // 대기 시간 기록 최대값(초)
+#define SIM_MAX_STOPS 32  // Sim_car 에 복사하는 정지 층 수
+#define SIM_QUEUE_CAPACITY 512 // 아직 태우지 않은 호출 수 기본 최대값
+#define SIM_MIN_IN_SERVICE 1    // 구역마다 운행 중이어야 하는 최소 엘리베이터 수 기본값
+#define SIM_MAINT_TOLERANCE 20  // 점검 시점을 앞당기거나 미룰 수 있는 승객 수 기본값
+
+/* sim_submit 결과(0 이상이면 받아들임) */
+#define SIM_OK 0
+#define SIM_BUSY 1     // 받았지만 큐가 많이 쌓였다(호출을 천천히 넣어야 한다)
+#define SIM_INVALID -1 // 층이나 사람 수가 잘못된 호출, 없는 호출 번호
+#define SIM_SHED -2    // 큐가 가득 차서 거절했다(나중에 다시 넣어야 한다)
+
+typedef struct _BUILDING Building;
+
+/* 호출 번호(sim_submit 이 돌려준다, 0 : 없음)
+ * 엘리베이터에 다 탈 때까지 유효하고, 그 뒤에는 옛 번호로 찾지 못한다.
+ * 아래 24비트는 호출 칸, 위 40비트는 칸을 다시 쓸 때마다 올리는 세대로,
+ * 빈 칸은 가장 오래 비어 있던 것부터 다시 쓰므로 같은 번호는 한 칸을 2^40 번 다시 써야 돌아온다. */
+typedef uint64_t Sim_id;
+
+/* 호출 하나 */
+typedef struct _SIMCALL
+{
+    int start_floor;
+    int dest_floor;
+    int num_people;
+    uint64_t tag; // 배정 결과를 받을 때 돌려주는 번호(0 : 받지 않음)
+} Sim_call;
+
+/* 호출이 엘리베이터에 배정되면 부른다.
+ * 큐에서 합쳐진 호출들은 한 번에 넘겨준다. elevator 는 0부터 센다.
+ * 태우기 전에 다른 엘리베이터로 옮기면 새 엘리베이터로 한 번 더 부른다.
+ * 진행하는 스레드가 건물 잠금을 잡은 채로 부른다(요청 큐의 잠금은 풀려 있다).
+ * 콜백 안에서 sim_submit, sim_submit_batch, sim_ticks 는 부를 수 있지만
+ * 같은 건물의 sim_cancel, sim_reset, sim_step 을 부르면 멈춘다. 결과는 옮겨 두고 바로 돌아온다. */
+typedef void (*Sim_assign_f)(void *ctx, const uint64_t *tags, int num_tags, int elevator);
+
+typedef struct _SIMSTOP
+{
+    int floor;  // -1 : 점검
+    int people; // + 태운다, - 내린다
+} Sim_stop;
+
+/* 엘리베이터 하나의 상태 */
+typedef struct _SIMCAR
+{
+    int current_floor;
+    int next_dest;
+    int current_people;
+    int total_people;  // 마지막 점검 후 태운 사람 수
+    int fix;           // 수리 중인지
+    int fix_remaining; // 남은 수리 시간(초)
+    int dwell;         // 남은 승하차 시간(초)
+    int num_stops;     // 남은 정지 층 수(stops 에는 SIM_MAX_STOPS 개 까지)
+    Sim_stop stops[SIM_MAX_STOPS];
+} Sim_car;
+
+/* 건물 하나의 운행 통계 */
+typedef struct _SIMSTATS
+{
+    int id;
+    int ticks;          // 시작 후 지난 시간(초)
+    int queue_depth;    // 배정을 기다리는 요청 수
+    int queue_peak;     // 가장 많이 쌓였던 요청 수
+    int backlog;        // 아직 태우지 않은 호출 수(큐에서 기다리거나 배정된, queue_capacity 와 비교한다)
+    int queue_delay_average; // 큐에 들어가서 배정될 때까지 걸린 시간(초, 다 못 타서 다시 부른 요청은 다시 부른 때부터)
+    int queue_delay_p95;
+    int queue_delay_p99;
+    int shed;           // 큐가 가득 차서 거절한 호출 수
+    int wait_average;   // 대기 시간(초)
+    int wait_p50;
+    int wait_p95;
+    int wait_p99;
+    int maint_advanced; // 점검을 앞당긴 횟수
+    int maint_deferred; // 점검을 미룬 횟수
+    int maint_forced;   // 허용 범위를 넘어 강제로 점검한 횟수
+    int rebalanced;     // 다른 엘리베이터로 옮긴 호출 수
+    int wait_hist[SIM_MAX_WAIT + 1]; // 대기 시간별 승객 수
+    int queue_hist[SIM_MAX_WAIT + 1]; // 배정될 때까지 큐에서 기다린 시간별 승객 수
+} Sim_stats;
+
+/* 한 틱이 끝났을 때의 건물 상태(내보낸 뒤에는 바뀌지 않는다) */
+typedef struct _SIMSNAPSHOT
+{
+    Sim_car cars[SIM_ELEVATORS];
+    Sim_stats stats;
+} Sim_snapshot;
+
+/* 1초(틱)를 진행할 때마다 부른다(잠금을 푼 뒤, 진행한 스레드에서).
+ * snapshot 은 방금 내보낸 상태로, 콜백이 끝날 때까지 유효하다. */
+typedef void (*Sim_tick_f)(void *ctx, Building *building, const Sim_snapshot *snapshot);
+
+typedef struct _SIMCONFIG
+{
+    int id;                 // 건물 번호
+    Sim_assign_f on_assign; // NULL : 배정 결과를 받지 않음
+    Sim_tick_f on_tick;     // NULL : 부르지 않음
+    void *ctx;              // 콜백에 넘겨주는 값
+    int queue_capacity;     // 아직 태우지 않은 호출 수(큐 + 배정됨) 최대값, 넘으면 SIM_SHED(0 : SIM_QUEUE_CAPACITY)
+    int queue_high_water;   // 이만큼 쌓이면 SIM_BUSY(0 : queue_capacity 의 3/4)
+    int min_in_service;     // 점검을 미뤄서라도 구역마다 운행시킬 엘리베이터 수(0 : SIM_MIN_IN_SERVICE, 구역의 엘리베이터 수 - 1 을 넘으면 줄인다)
+    int maint_tolerance;    // 점검을 앞당기거나 미룰 수 있는 승객 수(0 : SIM_MAINT_TOLERANCE)
+} Sim_config;
+
+Building *sim_create(const Sim_config *config);
+void sim_destroy(Building *building);
+void sim_reset(Building *building); // 처음 상태는 다음 틱에 내보낸다
+int sim_submit(Building *building, const Sim_call *call, Sim_id *id);
+int sim_submit_batch(Building *building, const Sim_call *calls, int n, int *status, Sim_id *ids);
+int sim_cancel(Building *building, Sim_id id); // 아직 타지 않은 호출을 지운다(SIM_INVALID : 없거나 이미 탔음)
+void sim_step(Building *building, int ticks);
+int sim_ticks(Building *building);
+Log_ring *sim_log(Building *building); // 기록 수준은 처음에 LOG_OFF
+
+/* 상태 읽기는 건물마다 한 스레드에서만 한다(진행하는 스레드는 on_tick 의 snapshot 을 쓴다).
+ * sim_snapshot 이 돌려준 상태는 그 스레드가 다시 부를 때까지 유효하다. */
+const Sim_snapshot *sim_snapshot(Building *building);
+void sim_cars(Building *building, Sim_car cars[SIM_ELEVATORS]);
+void sim_stats(Building *building, Sim_stats *stats);
+
+#endif
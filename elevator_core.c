@@ -0,0 +1,2439 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include "elevator.h"
+
+#define FLOOR SIM_FLOORS
+#define NUM_ELEVATORS SIM_ELEVATORS
+#define MAX_PEOPLE SIM_MAX_PEOPLE // 엘리베이터 정원
+#define MAX_TOTAL 150 // 점검 받아야하는 수
+#define BOARD_RATE 3  // 1초에 승하차 가능한 사람 수
+#define FULL_PENALTY 1 // 정원 초과로 다 못 태운 경우 추가 시간
+#define FIX_TIME 30 // 점검에 걸리는 시간
+#define NUM_ZONES 3 // 저층, 전층, 고층
+#define ZONE_CARS (NUM_ELEVATORS / NUM_ZONES) // 구역마다 엘리베이터 수
+#define DEMAND_LOW 0.1 // 남는 엘리베이터가 실어 나를 수 있는 양의 이 비율보다 수요가 적으면 점검을 앞당긴다
+#define DEMAND_WEIGHT 0.01 // 수요 예측 이동평균 가중치(약 100초 동안의 평균)
+#define MAX_WAIT SIM_MAX_WAIT // 대기 시간 기록 최대값(초)
+#define DISPATCH_PER_TICK 64 // 1초에 배정하는 최대 요청 수
+#define MAX_SCHEDULE 120     // 남은 일정이 이 시간(초) 이상인 엘리베이터에는 새 정지 층을 배정하지 않는다
+#define NUM_ROUTES 3 // 후보 엘리베이터가 같은 요청끼리 모은 큐 수(저층, 저층<->고층, 고층)
+#define DAY_TICKS 86400 // 하루(초)
+#define SLOT_TICKS 900  // 수요 기록 단위 시간(15분)
+#define NUM_SLOTS (DAY_TICKS / SLOT_TICKS)
+#define PARK_DELAY 10   // 이 시간 동안 할 일이 없으면 대기 층으로 이동한다
+#define REBALANCE_PER_TICK 16 // 1초에 재배정 검사로 지나가는 최대 정지 층 수
+#define REBALANCE_MARGIN 5   // 이만큼(초) 이상 빨리 태울 수 있어야 옮긴다
+#define WHEEL_BITS 6    // 타이머 바퀴 한 단계의 칸 수(2^6)
+#define WHEEL_SIZE (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS 4  // 64^4초(약 194일) 뒤까지 한 번에 건다
+#define TIMER_FIX 1     // 점검 끝
+#define TIMER_DWELL 2   // 승하차 끝
+#define TIMER_PARK 3    // 대기 층으로 이동 시작
+#define CALL_INDEX_BITS 24 // 호출 번호의 아래 24비트는 칸 번호, 위 40비트는 세대
+#define CALL_INDEX_MASK ((1u << CALL_INDEX_BITS) - 1)
+#define CALL_GENERATION ((uint64_t)1 << CALL_INDEX_BITS) // 세대 1
+#define CALL_CHUNK 1024    // 호출 칸을 한 번에 늘리는 수
+#define CALL_FREE 0        // 빈 칸
+#define CALL_QUEUED 1      // 큐에서 배정을 기다리는 중
+#define CALL_ASSIGNED 2    // 엘리베이터가 태우러 가는 중
+#define SNAPSHOT_MASK 3    // 상태 칸 번호(0 ~ 2)
+#define SNAPSHOT_FRESH 4   // 가운데 칸에 아직 읽지 않은 상태가 있다
+
+/* 호출 하나(건물의 호출 칸에 있고 번호로 찾는다)
+ * 같은 요청이나 정지 층에 합쳐진 호출들은 next 로 이어진다. */
+typedef struct _CALL
+{
+    struct _CALL *next;  // 합쳐진 다음 호출(빈 칸이면 다음 빈 칸)
+    uint64_t id;         // 세대 << CALL_INDEX_BITS | 칸 번호
+    int state;           // CALL_FREE, CALL_QUEUED, CALL_ASSIGNED
+    int people;
+    int dest_floor;
+    uint64_t tag;        // 배정 결과를 받을 때 돌려주는 번호
+    int reported;        // 배정된 엘리베이터를 알려줬는지
+    struct _REQUESTNODE *queued; // 기다리는 요청(CALL_QUEUED)
+    struct _FLOORNODE *pickup;   // 태우러 가는 정지 층(CALL_ASSIGNED)
+} Call;
+
+/* 요청 구조체 */
+typedef struct _REQUEST
+{
+    int start_floor; //현재층(요청이 이루어지는)
+    int dest_floor;  //목적층
+    int num_people;  //몇 명이 타는지
+    int call_time;   //호출 시각
+    int queue_time;  //큐에 들어간 시각(다 못 타서 다시 부르면 다시 부른 시각)
+    Call *calls;     //이 요청으로 태우는 호출들
+} Request;
+
+typedef struct _FLOORNODE
+{
+    struct _FLOORNODE *prev;
+    struct _FLOORNODE *next;
+    int floor;  // -1 : 점검
+    int people; //+ 태운다, - 내린다
+    int call_time; //호출 시각
+    struct _FLOORNODE *pair; //태우는 층 <-> 내리는 층
+    Call *calls; //태우는 층에서 태울 호출들(내리는 층은 NULL)
+    int moved; //다른 엘리베이터에서 옮겨온 태우는 층(다시 옮기지 않는다)
+} F_node;
+
+typedef struct _REQUESTNODE
+{
+    struct _REQUESTNODE *prev;
+    struct _REQUESTNODE *next;
+    Request req;
+} R_node;
+
+typedef struct _FLOORLIST
+{
+    F_node *head;
+    F_node *tail;
+} F_list;
+
+typedef struct _REQUESTLIST
+{
+    R_node *head;
+    R_node *tail;
+} R_list;
+
+/* 정해진 시각에 일어나는 일(타이머 바퀴의 칸에 매달린다) */
+typedef struct _TIMER
+{
+    struct _TIMER *prev;
+    struct _TIMER *next; // NULL : 걸려 있지 않음
+    struct _WHEEL *wheel;
+    int expires; // 끝나는 시각(틱)
+    int kind;    // TIMER_FIX, TIMER_DWELL, TIMER_PARK
+    int owner;   // 타이머를 건 엘리베이터
+} Timer;
+
+/* 계층 타이머 바퀴
+ * 가까운 타이머는 0단계 칸에, 먼 타이머는 위 단계 칸에 걸어두고
+ * 아래 단계가 한 바퀴 돌 때마다 위 단계의 한 칸을 아래로 내린다. */
+typedef struct _WHEEL
+{
+    int now; // 현재 시각(틱), 건물의 ticks 와 같다
+    Timer slots[WHEEL_LEVELS][WHEEL_SIZE]; // 칸마다 원형 리스트의 머리
+} Wheel;
+
+/* 상태 내보내기 버퍼(세 칸)
+ * 시뮬레이션은 back 칸에 상태를 다 쓴 뒤 가운데 칸(middle)과 바꾸고,
+ * 읽는 쪽은 새 상태가 있을 때만 front 칸을 가운데 칸과 바꾼다.
+ * 서로 다른 칸만 만지므로 쓰는 쪽도 읽는 쪽도 기다리지 않는다. */
+typedef struct _SNAPSHOTS
+{
+    Sim_snapshot slots[3];
+    int finished[3];               // 칸의 평균, 백분위수를 계산했는지
+    int hist_version[3];           // 칸에 복사한 대기 시간 기록의 판(건물 잠금으로 보호)
+    int back;                      // 시뮬레이션이 다음에 쓸 칸(건물 잠금으로 보호)
+    _Alignas(64) _Atomic int middle; // 주고받는 칸(+ SNAPSHOT_FRESH)
+    _Alignas(64) int front;        // 읽는 쪽이 보고 있는 칸
+} Snapshots;
+
+/* 엘리베이터 구조체 */
+typedef struct _ELEVATOR
+{
+    int current_floor;
+    int next_dest;
+    int current_people;
+    int total_people;
+    int fix;
+    int awake; // 0 : 타이머나 호출을 기다리는 중(이동시키지 않는다)
+    Timer timer; // 점검, 승하차, 대기 타이머
+    int deferred; // 점검이 미뤄진 상태인지
+    int idle_since; // 할 일이 없어진 시각(-1 : 운행 중)
+    int park_floor; // 대기하러 가는 층(0 : 없음)
+    struct _FLOORNODE *rebalance_at; // 재배정 검사를 이어서 할 정지 층(NULL : 처음부터)
+    F_list pending;
+    F_node *trips[FLOOR + 1][FLOOR + 1]; // 아직 태우지 않은 (출발 층, 목적 층) 정지 층
+} Elevator;
+
+/* 건물 하나의 시뮬레이션 상태 */
+struct _BUILDING
+{
+    int id;
+    Sim_assign_f on_assign;     // 배정 결과를 알려준다
+    Sim_tick_f on_tick;         // 1초 진행할 때마다 알려준다
+    void *ctx;
+    Log_ring *log;              // 운행 일지 기록(다른 스레드가 꺼내 간다)
+    Snapshots *snapshots;       // 매 틱 끝의 상태(다른 스레드가 잠금 없이 읽는다)
+    Elevator *elevators[NUM_ELEVATORS];
+    R_list reqs[NUM_ROUTES];    // 새로 들어와 배정을 기다리는 요청
+    R_list retries[NUM_ROUTES]; // 다 못 타서 다시 부른 요청(처음 호출 시각을 그대로 가진다)
+    R_node *queued[FLOOR + 1][FLOOR + 1]; // 큐에서 (출발 층, 목적 층)이 같은 요청
+    pthread_mutex_t reqs_lock;  // 소켓 스레드와 요청 큐를 공유
+    pthread_mutex_t lock;       // 화면 출력, 재시작과 시뮬레이션을 구분
+    int ticks;                  // 시뮬레이션 시작 후 지난 시간(초, 바꿀 때는 요청 큐의 잠금도 잡는다)
+    Wheel wheel;                // 점검, 승하차, 대기 타이머
+    int queue_size;             // 모든 큐에 쌓인 요청 수(요청 큐의 잠금으로 보호)
+    int num_calls;              // 아직 태우지 않은 호출 수(큐에서 기다리거나 배정된, 요청 큐의 잠금으로 보호)
+    int queue_capacity;         // 태우지 않은 호출이 이만큼 쌓이면 새 호출을 거절한다
+    int queue_high_water;       // 태우지 않은 호출이 이만큼 쌓이면 호출 넣는 쪽에 속도를 줄이라고 알린다
+    int min_in_service;         // 구역마다 운행 중이어야 하는 최소 엘리베이터 수
+    int maint_tolerance;        // 점검 시점을 앞당기거나 미룰 수 있는 승객 수
+    Call **call_chunks;         // 호출 칸(CALL_CHUNK 개씩 늘리고 옮기지 않는다)
+    int num_call_chunks;
+    Call *free_calls;           // 빈 호출 칸, 오래 비어 있던 것부터(요청 큐의 잠금으로 보호)
+    Call *free_calls_tail;      // 마지막 빈 칸(놓아준 칸은 뒤에 붙인다)
+
+    /* 운행 통계 */
+    double demand[NUM_ZONES];   // 구역별 예상 수요(초당 승객 수)
+    int zone_calls[NUM_ZONES];  // 이번 1초 동안 구역에 배정된 승객 수
+    int wait_hist[MAX_WAIT + 1]; // 대기 시간별 승객 수
+    int floor_demand[NUM_SLOTS][NUM_ZONES][FLOOR + 1]; // 시간대별, 구역별(배정될 수 있는 호출만), 층별 탑승 승객 수
+    int demand_slot;            // 마지막으로 기록한 시간대
+    int maint_advanced;         // 점검을 앞당긴 횟수
+    int maint_deferred;         // 점검을 미룬 횟수
+    int maint_forced;           // 허용 범위를 넘어 강제로 점검한 횟수
+    int rebalance_car;          // 다음에 재배정을 검사할 엘리베이터
+    int rebalanced;             // 다른 엘리베이터로 옮긴 호출 수
+    int queue_peak;             // 가장 많이 쌓였던 요청 수
+    int shed;                   // 큐가 가득 차서 거절한 호출 수
+    int queue_hist[MAX_WAIT + 1]; // 배정될 때까지 큐에서 기다린 시간별 승객 수
+    int hist_version;           // 두 대기 시간 기록이 바뀔 때마다 올린다
+};
+
+Building *building_create(const Sim_config *config);
+void building_reset(Building *building);
+void building_free(Building *building);
+void building_step(Building *building);
+void report_assign(Building *building, Request *req, int elevator);
+const Sim_snapshot *publish_snapshot(Building *building);
+void fill_cars(Building *building, Sim_car cars[SIM_ELEVATORS]);
+void fill_stats(Building *building, Sim_stats *stats);
+void finish_stats(Sim_stats *stats);
+void insert_into_queue(Building *building, int current_floor, int dest_floor, int num_people, int call_time, Call *calls);
+void queue_request(Building *building, Request *req, R_list lists[NUM_ROUTES]);
+int can_dispatch(Building *building, int route);
+int route_of(int start_floor, int dest_floor);
+int merge_into_trip(Elevator *elevators[6], Request *current);
+void forget_trip(Elevator *elevator, F_node *stop);
+void remove_stop(Building *building, F_node *stop);
+int merge_call_time(int call_time, int people, int new_call_time, int new_people);
+Call *call_alloc(Building *building);
+void call_release(Building *building, Call *call);
+void call_push_free(Building *building, Call *call);
+Call *call_find(Building *building, uint64_t id);
+void calls_reset(Building *building);
+void attach_calls(Call *calls, R_node *queued, F_node *pickup);
+Call *join_calls(Call *calls, Call *more);
+Call *board_calls(Building *building, Call *calls, int boarded);
+void cancel_call(Building *building, Call *call);
+int valid_request(int current_floor, int dest_floor, int num_people);
+int dispatch_request(Building *building, Request *current);
+void assign_request(Elevator *response, Request *current);
+Elevator *find_elevator(Building *building, Request *current);
+void candidate_range(int start_floor, int dest_floor, int *first, int *count);
+int pickup_time(Elevator *elevator, int start_floor, int dest_floor);
+int accepting(Elevator *elevator);
+int schedule_time(Elevator *elevator);
+void rebalance(Building *building);
+int rebalance_trip(Building *building, int index, F_node *pickup);
+F_node *find_ideal_location(Elevator *elevator, int start_floor, int dest_floor, int target);
+int find_time(F_list list, F_node *target, int start, int end, int load);
+int board_time(int people);
+int stop_time(int people, int *load);
+int find_min(int *arr, int n);
+void move_elevator(Building *building);
+F_node *find_dropoff(Elevator *elevator);
+int zone_of(int index);
+int in_service(Elevator *elevator);
+double car_capacity(int index);
+void schedule_maintenance(Building *building);
+void update_demand(Building *building);
+void record_wait(Building *building, int wait, int people);
+void record_wait_hist(int *hist, int wait, int people);
+int wait_percentile(int *hist, int percent);
+int wait_average(int *hist);
+void record_floor_demand(Building *building, int floor, int dest_floor, int people);
+void park_elevator(Building *building, int index);
+int find_park_floor(Building *building, int index);
+int serves_floor(int index, int floor);
+void wake_elevator(Elevator *elevator);
+int busy_time(Elevator *elevator);
+void wheel_init(Wheel *wheel);
+void wheel_insert(Wheel *wheel, Timer *timer, int base);
+void wheel_advance(Building *building);
+void timer_add(Wheel *wheel, Timer *timer, int kind, int expires);
+void timer_cancel(Timer *timer);
+int timer_left(Timer *timer);
+void timer_expire(Building *building, Timer *timer);
+void R_list_init(R_list *list);
+void R_list_clear(R_list list);
+R_node *R_list_insert(R_list list, Request *req);
+Request R_list_unlink(R_node *node);
+F_node *F_list_insert(F_list list, F_node *after, int floor, int people, int call_time);
+int F_list_size(F_list list);
+void F_list_remove(F_list list);
+void F_list_unlink(F_node *node);
+void F_list_move(F_node *node, F_node *prev);
+F_node *F_list_peek(F_list list);
+
+Building *sim_create(const Sim_config *config)
+{
+    Sim_config defaults;
+
+    if (config == NULL)
+    {
+        memset(&defaults, 0, sizeof(defaults));
+        config = &defaults;
+    }
+    return building_create(config);
+}
+
+void sim_destroy(Building *building)
+{
+    building_free(building);
+}
+
+void sim_reset(Building *building)
+{
+    pthread_mutex_lock(&building->lock);
+    building_reset(building);
+    pthread_mutex_unlock(&building->lock);
+}
+
+int sim_submit(Building *building, const Sim_call *call, Sim_id *id)
+{
+    int status;
+
+    sim_submit_batch(building, call, 1, &status, id);
+    return status;
+}
+
+int sim_submit_batch(Building *building, const Sim_call *calls, int n, int *status, Sim_id *ids)
+{
+    Request req;
+    Call *call;
+    int accepted = 0;
+    int i;
+
+    // 여러 호출을 잠금 한 번으로 큐에 넣는다.
+    // status 에 호출마다 결과를, ids 에 호출 번호를 적고(NULL 이면 적지 않음), 받아들인 호출 수를 돌려준다.
+    // 아직 태우지 않은 호출(큐 + 엘리베이터에 배정된)이 가득 차면 거절하고(SIM_SHED), 많이 쌓였으면 받되 SIM_BUSY 로 알린다.
+    // 엘리베이터는 일정이 밀리면 새 호출을 받지 않으므로(accepting) 밀린 호출은 큐에 남아 여기서 세어진다.
+
+    pthread_mutex_lock(&building->reqs_lock);
+    for (i = 0; i < n; i++)
+    {
+        if (ids != NULL)
+        {
+            ids[i] = 0;
+        }
+        if (!valid_request(calls[i].start_floor, calls[i].dest_floor, calls[i].num_people))
+        {
+            status[i] = SIM_INVALID;
+            continue;
+        }
+        if (building->num_calls >= building->queue_capacity)
+        {
+            status[i] = SIM_SHED;
+            building->shed++;
+            continue;
+        }
+        // 호출 번호를 더 만들 수 없으면(칸 번호를 다 쓰면) 받지 않는다
+        call = call_alloc(building);
+        if (call == NULL)
+        {
+            status[i] = SIM_INVALID;
+            continue;
+        }
+        call->people = calls[i].num_people;
+        call->dest_floor = calls[i].dest_floor;
+        call->tag = calls[i].tag;
+
+        req.start_floor = calls[i].start_floor;
+        req.dest_floor = calls[i].dest_floor;
+        req.num_people = calls[i].num_people;
+        req.call_time = building->ticks;
+        req.queue_time = building->ticks;
+        req.calls = call;
+        queue_request(building, &req, building->reqs);
+        if (ids != NULL)
+        {
+            ids[i] = call->id;
+        }
+        status[i] = building->num_calls >= building->queue_high_water ? SIM_BUSY : SIM_OK;
+        accepted++;
+    }
+    pthread_mutex_unlock(&building->reqs_lock);
+    return accepted;
+}
+
+int sim_cancel(Building *building, Sim_id id)
+{
+    Call *call;
+    int status = SIM_INVALID;
+
+    // 시뮬레이션과 요청 큐를 모두 잠그고(building_step 과 같은 순서로) 호출을 지운다
+    pthread_mutex_lock(&building->lock);
+    pthread_mutex_lock(&building->reqs_lock);
+    call = call_find(building, id);
+    if (call != NULL)
+    {
+        cancel_call(building, call);
+        status = SIM_OK;
+    }
+    pthread_mutex_unlock(&building->reqs_lock);
+    pthread_mutex_unlock(&building->lock);
+    return status;
+}
+
+void sim_step(Building *building, int ticks)
+{
+    int i;
+    for (i = 0; i < ticks; i++)
+    {
+        building_step(building);
+    }
+}
+
+int sim_ticks(Building *building)
+{
+    int ticks;
+
+    pthread_mutex_lock(&building->reqs_lock);
+    ticks = building->ticks;
+    pthread_mutex_unlock(&building->reqs_lock);
+    return ticks;
+}
+
+Log_ring *sim_log(Building *building)
+{
+    return building->log;
+}
+
+const Sim_snapshot *sim_snapshot(Building *building)
+{
+    Snapshots *snapshots = building->snapshots;
+
+    // 새로 내보낸 상태가 있으면 보던 칸을 내주고 가져온다.
+    // 평균, 백분위수는 가져온 쪽이 한 번만 계산한다(진행을 느리게 하지 않도록).
+    if (atomic_load_explicit(&snapshots->middle, memory_order_relaxed) & SNAPSHOT_FRESH)
+    {
+        snapshots->front = atomic_exchange_explicit(&snapshots->middle, snapshots->front, memory_order_acq_rel) & SNAPSHOT_MASK;
+        if (!snapshots->finished[snapshots->front])
+        {
+            finish_stats(&snapshots->slots[snapshots->front].stats);
+            snapshots->finished[snapshots->front] = 1;
+        }
+    }
+    return &snapshots->slots[snapshots->front];
+}
+
+void sim_cars(Building *building, Sim_car cars[SIM_ELEVATORS])
+{
+    memcpy(cars, sim_snapshot(building)->cars, sizeof(Sim_car) * SIM_ELEVATORS);
+}
+
+void sim_stats(Building *building, Sim_stats *stats)
+{
+    memcpy(stats, &sim_snapshot(building)->stats, sizeof(Sim_stats));
+}
+
+Building *building_create(const Sim_config *config)
+{
+    Building *building = (Building *)malloc(sizeof(Building));
+    Elevator **elevators = building->elevators;
+    int i;
+
+    building->id = config->id;
+    building->on_assign = config->on_assign;
+    building->on_tick = config->on_tick;
+    building->ctx = config->ctx;
+    building->log = (Log_ring *)aligned_alloc(_Alignof(Log_ring), sizeof(Log_ring));
+    memset(building->log, 0, sizeof(Log_ring));
+    building->snapshots = (Snapshots *)aligned_alloc(_Alignof(Snapshots), sizeof(Snapshots));
+    memset(building->snapshots, 0, sizeof(Snapshots));
+    building->snapshots->back = 0;
+    atomic_init(&building->snapshots->middle, 1);
+    building->snapshots->front = 2;
+    for (i = 0; i < NUM_ROUTES; i++)
+    {
+        R_list_init(&building->reqs[i]);
+        R_list_init(&building->retries[i]);
+    }
+    building->queue_capacity = config->queue_capacity > 0 ? config->queue_capacity : SIM_QUEUE_CAPACITY;
+    building->queue_high_water = config->queue_high_water > 0 ? config->queue_high_water : building->queue_capacity * 3 / 4;
+    if (building->queue_high_water > building->queue_capacity)
+    {
+        building->queue_high_water = building->queue_capacity;
+    }
+    building->min_in_service = config->min_in_service > 0 ? config->min_in_service : SIM_MIN_IN_SERVICE;
+    // 점검하는 엘리베이터를 빼면 같은 구역에 ZONE_CARS - 1 대만 남으므로 그보다 많이 요구하면 점검을 늘 미루게 된다
+    if (building->min_in_service > ZONE_CARS - 1)
+    {
+        building->min_in_service = ZONE_CARS - 1;
+    }
+    building->maint_tolerance = config->maint_tolerance > 0 ? config->maint_tolerance : SIM_MAINT_TOLERANCE;
+    pthread_mutex_init(&building->reqs_lock, NULL);
+    pthread_mutex_init(&building->lock, NULL);
+    building->call_chunks = NULL;
+    building->num_call_chunks = 0;
+    building->free_calls = NULL;
+    building->free_calls_tail = NULL;
+    building->num_calls = 0;
+    building->hist_version = 0;
+
+    for (i = 0; i < NUM_ELEVATORS; i++)
+    {
+        elevators[i] = (Elevator *)malloc(sizeof(Elevator));
+        elevators[i]->pending.head = (F_node *)malloc(sizeof(F_node));
+        elevators[i]->pending.tail = (F_node *)malloc(sizeof(F_node));
+        elevators[i]->pending.head->floor = 0;
+        elevators[i]->pending.tail->floor = 0;
+        elevators[i]->pending.head->prev = NULL;
+        elevators[i]->pending.head->next = elevators[i]->pending.tail;
+        elevators[i]->pending.tail->prev = elevators[i]->pending.head;
+        elevators[i]->pending.tail->next = NULL;
+    }
+
+    building_reset(building);
+    publish_snapshot(building);
+    return building;
+}
+
+void building_reset(Building *building)
+{
+    Elevator **elevators = building->elevators;
+    int i;
+
+    //엘리베이터 : 1, 2 - 저층, 3, 4 - 전층, 5, 6 - 고층
+    for (i = 0; i < NUM_ELEVATORS; i++)
+    {
+        while (F_list_size(elevators[i]->pending) > 0)
+        {
+            F_list_remove(elevators[i]->pending);
+        }
+
+        elevators[i]->current_floor = 1;
+        elevators[i]->next_dest = 1;
+        elevators[i]->current_people = 0;
+        elevators[i]->total_people = 0;
+        elevators[i]->fix = 0;
+        elevators[i]->awake = 1;
+        elevators[i]->timer.next = NULL;
+        elevators[i]->timer.kind = 0;
+        elevators[i]->timer.owner = i;
+        elevators[i]->deferred = 0;
+        elevators[i]->idle_since = -1;
+        elevators[i]->park_floor = 0;
+        elevators[i]->rebalance_at = NULL;
+        memset(elevators[i]->trips, 0, sizeof(elevators[i]->trips));
+    }
+
+    // 고층 엘리베이터는 처음 11층에 멈춰있음
+    elevators[4]->current_floor = 11;
+    elevators[4]->next_dest = 11;
+    elevators[5]->current_floor = 11;
+    elevators[5]->next_dest = 11;
+
+    //요청 목록 초기화
+    pthread_mutex_lock(&building->reqs_lock);
+    for (i = 0; i < NUM_ROUTES; i++)
+    {
+        R_list_clear(building->reqs[i]);
+        R_list_clear(building->retries[i]);
+    }
+    memset(building->queued, 0, sizeof(building->queued));
+    building->queue_size = 0;
+    building->queue_peak = 0;
+    building->shed = 0;
+    calls_reset(building);
+    building->ticks = 0;
+    pthread_mutex_unlock(&building->reqs_lock);
+
+    //운행 통계 초기화
+    wheel_init(&building->wheel);
+    memset(building->queue_hist, 0, sizeof(building->queue_hist));
+    building->hist_version++;
+    memset(building->demand, 0, sizeof(building->demand));
+    memset(building->zone_calls, 0, sizeof(building->zone_calls));
+    memset(building->wait_hist, 0, sizeof(building->wait_hist));
+    memset(building->floor_demand, 0, sizeof(building->floor_demand));
+    building->demand_slot = 0;
+    building->maint_advanced = 0;
+    building->maint_deferred = 0;
+    building->maint_forced = 0;
+    building->rebalance_car = 0;
+    building->rebalanced = 0;
+}
+
+void building_free(Building *building)
+{
+    int i;
+
+    for (i = NUM_ELEVATORS - 1; i >= 0; i--)
+    {
+        while (F_list_size(building->elevators[i]->pending) > 0)
+        {
+            F_list_remove(building->elevators[i]->pending);
+        }
+        free(building->elevators[i]->pending.tail);
+        free(building->elevators[i]->pending.head);
+        free(building->elevators[i]);
+    }
+
+    for (i = 0; i < NUM_ROUTES; i++)
+    {
+        R_list_clear(building->reqs[i]);
+        R_list_clear(building->retries[i]);
+        free(building->reqs[i].head);
+        free(building->reqs[i].tail);
+        free(building->retries[i].head);
+        free(building->retries[i].tail);
+    }
+
+    for (i = 0; i < building->num_call_chunks; i++)
+    {
+        free(building->call_chunks[i]);
+    }
+    free(building->call_chunks);
+
+    pthread_mutex_destroy(&building->reqs_lock);
+    pthread_mutex_destroy(&building->lock);
+    free(building->snapshots);
+    free(building->log);
+    free(building);
+}
+
+void building_step(Building *building)
+{
+    int num_reqs = 0;   // 이번에 배정한 요청 수
+    int response;       // 요청에 응답하는 엘리베이터
+    Request current;    // 처리할 요청
+    int open[NUM_ROUTES]; // 새 호출을 받을 엘리베이터가 있는 경로인지
+    int route = 0;        // 꺼낼 요청의 경로
+    R_node *node;
+    R_node *head;
+    int r;
+    const Sim_snapshot *snapshot; // 이번 틱 끝의 상태
+
+    // 1. 점검이 필요한 엘리베이터에 점검 요청을 넣는다.
+    // 2. 엘리베이터 호출이 들어오면 호출에 응한다.
+    // 2-1. 새 호출을 받을 엘리베이터가 없는(모두 만원, 점검이거나 일정이 밀린) 경로의 큐는 건너뛴다.
+    //      일정이 밀린 경로의 요청은 큐에 남으므로 태우지 않은 호출이 쌓여 SIM_BUSY, SIM_SHED 로 호출 넣는 쪽에 알려진다.
+    // 2-2. 나머지 큐의 맨 앞 중 먼저 부른 요청부터 꺼낸다.
+    // 2-3. 응답할 엘리베이터를 선택하고 요청을 넣는다.
+    // 2-4. 아직 태우지 않은 호출을 더 빨리 태울 수 있는 엘리베이터로 옮긴다.
+    // 3. 엘리베이터를 이동시킨다.
+    // 4. 상태를 복사해 내보낸다.
+
+    pthread_mutex_lock(&building->lock);
+
+    //점검 필요한 엘리베이터 있으면 점검 요청 넣기(맨 마지막에)
+    schedule_maintenance(building);
+
+    // 막힌 경로의 요청은 건너뛰므로 큐가 길어도 1초에 보는 요청은 늘지 않는다.
+    // 배정할수록 일정이 길어지므로 꺼내기 전에 그 경로를 다시 본다.
+    for (r = 0; r < NUM_ROUTES; r++)
+    {
+        open[r] = can_dispatch(building, r);
+    }
+
+    // 쌓인 요청을 1초에 DISPATCH_PER_TICK 개 까지 배정한다.
+    // 잠금을 푼 사이에는 큐 뒤에 붙거나 합쳐지기만 하고, 꺼내는 것은 이 스레드뿐이다.
+    pthread_mutex_lock(&building->reqs_lock);
+    while (num_reqs < DISPATCH_PER_TICK)
+    {
+        node = NULL;
+        for (r = 0; r < NUM_ROUTES; r++)
+        {
+            if (!open[r])
+            {
+                continue;
+            }
+            head = building->retries[r].head->next;
+            if (head != building->retries[r].tail && (node == NULL || head->req.call_time < node->req.call_time))
+            {
+                node = head;
+                route = r;
+            }
+            head = building->reqs[r].head->next;
+            if (head != building->reqs[r].tail && (node == NULL || head->req.call_time < node->req.call_time))
+            {
+                node = head;
+                route = r;
+            }
+        }
+        if (node == NULL)
+        {
+            break;
+        }
+        if (num_reqs > 0 && !can_dispatch(building, route))
+        {
+            open[route] = 0;
+            continue;
+        }
+
+        if (building->queued[node->req.start_floor][node->req.dest_floor] == node)
+        {
+            building->queued[node->req.start_floor][node->req.dest_floor] = NULL;
+        }
+        current = R_list_unlink(node);
+        building->queue_size--;
+        pthread_mutex_unlock(&building->reqs_lock);
+
+        // 큐에서 기다린 시간만 센다(다시 부른 요청이 엘리베이터를 기다린 시간은 빼고)
+        record_wait_hist(building->queue_hist, building->ticks - current.queue_time, current.num_people);
+        building->hist_version++;
+        response = dispatch_request(building, &current);
+        building->zone_calls[zone_of(response)] += current.num_people;
+        report_assign(building, &current, response);
+        num_reqs++;
+
+        pthread_mutex_lock(&building->reqs_lock);
+    }
+    pthread_mutex_unlock(&building->reqs_lock);
+
+    // 늦어진 배정 다시 검사하기
+    rebalance(building);
+
+    // 엘리베이터 이동시키기
+    move_elevator(building);
+    update_demand(building);
+    // 호출 넣는 스레드는 요청 큐의 잠금만 잡고 호출 시각(ticks)을 읽는다
+    pthread_mutex_lock(&building->reqs_lock);
+    building->ticks++;
+    pthread_mutex_unlock(&building->reqs_lock);
+    wheel_advance(building);
+
+    // 화면, 통계, 외부 도구는 이 상태만 읽는다
+    snapshot = publish_snapshot(building);
+
+    pthread_mutex_unlock(&building->lock);
+
+    // 외부 도구에 상태 공개
+    if (building->on_tick != NULL)
+    {
+        building->on_tick(building->ctx, building, snapshot);
+    }
+}
+
+const Sim_snapshot *publish_snapshot(Building *building)
+{
+    Snapshots *snapshots = building->snapshots;
+    int slot = snapshots->back;
+
+    // back 칸에 상태를 다 쓴 뒤에 가운데 칸과 바꾼다.
+    // 내보낸 칸은 시뮬레이션이 다음 틱에 다시 받기 전까지 바뀌지 않는다.
+    // on_tick 이 있으면 넘겨주기 전에 평균, 백분위수까지 계산해둔다.
+    fill_cars(building, snapshots->slots[slot].cars);
+    fill_stats(building, &snapshots->slots[slot].stats);
+    // 대기 시간 기록은 크므로 그 칸에 복사한 뒤 바뀌었을 때만 다시 복사한다
+    if (snapshots->hist_version[slot] != building->hist_version)
+    {
+        memcpy(snapshots->slots[slot].stats.wait_hist, building->wait_hist, sizeof(building->wait_hist));
+        memcpy(snapshots->slots[slot].stats.queue_hist, building->queue_hist, sizeof(building->queue_hist));
+        snapshots->hist_version[slot] = building->hist_version;
+    }
+    snapshots->finished[slot] = building->on_tick != NULL;
+    if (snapshots->finished[slot])
+    {
+        finish_stats(&snapshots->slots[slot].stats);
+    }
+    snapshots->back = atomic_exchange_explicit(&snapshots->middle, slot | SNAPSHOT_FRESH, memory_order_acq_rel) & SNAPSHOT_MASK;
+    return &snapshots->slots[slot];
+}
+
+void fill_cars(Building *building, Sim_car cars[SIM_ELEVATORS])
+{
+    Elevator *elevator;
+    F_node *curr;
+    int i;
+
+    for (i = 0; i < NUM_ELEVATORS; i++)
+    {
+        elevator = building->elevators[i];
+        cars[i].current_floor = elevator->current_floor;
+        cars[i].next_dest = elevator->next_dest;
+        cars[i].current_people = elevator->current_people;
+        cars[i].total_people = elevator->total_people;
+        cars[i].fix = elevator->fix;
+        cars[i].fix_remaining = elevator->fix ? busy_time(elevator) : 0;
+        cars[i].dwell = elevator->fix ? 0 : busy_time(elevator);
+
+        // 정지 층은 SIM_MAX_STOPS 개 까지 복사하고 개수는 모두 센다
+        cars[i].num_stops = 0;
+        for (curr = elevator->pending.head->next; curr != elevator->pending.tail; curr = curr->next)
+        {
+            if (cars[i].num_stops < SIM_MAX_STOPS)
+            {
+                cars[i].stops[cars[i].num_stops].floor = curr->floor;
+                cars[i].stops[cars[i].num_stops].people = curr->people;
+            }
+            cars[i].num_stops++;
+        }
+    }
+}
+
+void fill_stats(Building *building, Sim_stats *stats)
+{
+    stats->id = building->id;
+    stats->ticks = building->ticks;
+    pthread_mutex_lock(&building->reqs_lock);
+    stats->queue_depth = building->queue_size;
+    stats->queue_peak = building->queue_peak;
+    stats->backlog = building->num_calls;
+    stats->shed = building->shed;
+    pthread_mutex_unlock(&building->reqs_lock);
+    stats->maint_advanced = building->maint_advanced;
+    stats->maint_deferred = building->maint_deferred;
+    stats->maint_forced = building->maint_forced;
+    stats->rebalanced = building->rebalanced;
+}
+
+void finish_stats(Sim_stats *stats)
+{
+    stats->queue_delay_average = wait_average(stats->queue_hist);
+    stats->queue_delay_p95 = wait_percentile(stats->queue_hist, 95);
+    stats->queue_delay_p99 = wait_percentile(stats->queue_hist, 99);
+    stats->wait_average = wait_average(stats->wait_hist);
+    stats->wait_p50 = wait_percentile(stats->wait_hist, 50);
+    stats->wait_p95 = wait_percentile(stats->wait_hist, 95);
+    stats->wait_p99 = wait_percentile(stats->wait_hist, 99);
+}
+
+void report_assign(Building *building, Request *req, int elevator)
+{
+    uint64_t tags[MAX_PEOPLE]; // 합쳐진 호출은 1명 이상씩이라 정원을 넘지 않는다
+    int num_tags = 0;
+    Call *call;
+
+    // 건물 잠금을 잡은 채로 부른다(on_assign 이 할 수 있는 일은 elevator.h 의 Sim_assign_f 참고).
+    // 요청에 합쳐진 호출들까지 모두 알려준다.
+    // 다 못 타서 다시 부른 호출은 이미 알려줬으므로 다시 알리지 않는다.
+    // 다른 엘리베이터로 옮긴 호출은 rebalance_trip 이 reported 를 지워서 새 엘리베이터를 다시 알린다.
+
+    for (call = req->calls; call != NULL && num_tags < MAX_PEOPLE; call = call->next)
+    {
+        if (call->tag != 0 && !call->reported)
+        {
+            tags[num_tags++] = call->tag;
+        }
+        call->reported = 1;
+    }
+    if (num_tags > 0 && building->on_assign != NULL)
+    {
+        building->on_assign(building->ctx, tags, num_tags, elevator);
+    }
+}
+
+void insert_into_queue(Building *building, int current_floor, int dest_floor, int num_people, int call_time, Call *calls)
+{
+    Request req;
+
+    if (!valid_request(current_floor, dest_floor, num_people))
+    {
+        return;
+    }
+
+    req.start_floor = current_floor;
+    req.dest_floor = dest_floor;
+    req.num_people = num_people;
+    req.call_time = call_time;
+    req.queue_time = building->ticks;
+    req.calls = calls;
+
+    pthread_mutex_lock(&building->reqs_lock);
+    queue_request(building, &req, building->retries);
+    pthread_mutex_unlock(&building->reqs_lock);
+}
+
+void queue_request(Building *building, Request *req, R_list lists[NUM_ROUTES])
+{
+    R_node *same = building->queued[req->start_floor][req->dest_floor];
+
+    // 요청 큐의 잠금을 잡은 상태에서 부른다.
+    // (출발 층, 목적 층)이 같은 요청이 큐 중 하나에 있고 한 번에 태울 수 있으면 합친다.
+    // 합쳐진 호출에는 배정할 때 같은 엘리베이터로 응답한다.
+    // 합칠 수 없으면 lists 중 요청의 경로에 맞는 큐의 맨 뒤에 넣는다.
+
+    if (same == NULL || same->req.num_people + req->num_people > MAX_PEOPLE)
+    {
+        same = R_list_insert(lists[route_of(req->start_floor, req->dest_floor)], req);
+        building->queued[req->start_floor][req->dest_floor] = same;
+        attach_calls(req->calls, same, NULL);
+        building->queue_size++;
+        if (building->queue_size > building->queue_peak)
+        {
+            building->queue_peak = building->queue_size;
+        }
+        return;
+    }
+
+    same->req.call_time = merge_call_time(same->req.call_time, same->req.num_people, req->call_time, req->num_people);
+    same->req.queue_time = merge_call_time(same->req.queue_time, same->req.num_people, req->queue_time, req->num_people);
+    same->req.num_people += req->num_people;
+    attach_calls(req->calls, same, NULL);
+    same->req.calls = join_calls(same->req.calls, req->calls);
+}
+
+int can_dispatch(Building *building, int route)
+{
+    int s, size, i;
+
+    // 경로의 후보 엘리베이터 중 하나라도 새 호출을 받을 수 있는지(pickup_time 이 INT_MAX 가 아닌지)
+    //엘리베이터 : 저층 - 1 ~ 4호기, 저층<->고층 - 3, 4호기, 고층 - 3 ~ 6호기(route_of)
+    s = route == 0 ? 0 : 2;
+    size = route == 1 ? 2 : 4;
+    for (i = s; i < s + size; i++)
+    {
+        if (accepting(building->elevators[i]))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int merge_into_trip(Elevator *elevators[6], Request *current)
+{
+    F_node *pickup;
+    int i;
+
+    // 아직 태우지 않은 (출발 층, 목적 층)이 같은 정지 층이 있으면
+    // 새 정지 층을 만들지 않고 그 정지 층에 사람 수만 더한다.
+
+    for (i = 0; i < NUM_ELEVATORS; i++)
+    {
+        pickup = elevators[i]->trips[current->start_floor][current->dest_floor];
+        if (pickup == NULL || !in_service(elevators[i]))
+        {
+            continue;
+        }
+        if (pickup->people + current->num_people > MAX_PEOPLE)
+        {
+            continue;
+        }
+
+        pickup->call_time = merge_call_time(pickup->call_time, pickup->people, current->call_time, current->num_people);
+        pickup->people += current->num_people;
+        pickup->pair->people -= current->num_people;
+        attach_calls(current->calls, NULL, pickup);
+        pickup->calls = join_calls(pickup->calls, current->calls);
+        return i;
+    }
+    return -1;
+}
+
+void forget_trip(Elevator *elevator, F_node *stop)
+{
+    F_node *pickup = stop->people > 0 ? stop : stop->pair;
+
+    // 태우는 층이나 내리는 층 중 하나에 도착하면 더 이상 합칠 수 없다
+    if (stop->pair == NULL)
+    {
+        return;
+    }
+    if (elevator->trips[pickup->floor][pickup->pair->floor] == pickup)
+    {
+        elevator->trips[pickup->floor][pickup->pair->floor] = NULL;
+    }
+    stop->pair->pair = NULL;
+    stop->pair = NULL;
+}
+
+void remove_stop(Building *building, F_node *stop)
+{
+    int i;
+
+    // 시뮬레이션 중에 정지 층을 지운다.
+    // 재배정 검사를 이어서 할 정지 층이었으면 다음 정지 층부터 검사하도록 옮긴다.
+    for (i = 0; i < NUM_ELEVATORS; i++)
+    {
+        if (building->elevators[i]->rebalance_at == stop)
+        {
+            building->elevators[i]->rebalance_at = stop->next;
+        }
+    }
+    F_list_unlink(stop);
+}
+
+int merge_call_time(int call_time, int people, int new_call_time, int new_people)
+{
+    // 합쳐진 승객들의 평균 대기 시간이 맞도록 호출 시각을 사람 수로 가중 평균한다
+    return (int)(((long)call_time * people + (long)new_call_time * new_people) / (people + new_people));
+}
+
+Call *call_alloc(Building *building)
+{
+    Call *chunk;
+    Call **chunks;
+    int i;
+
+    // 요청 큐의 잠금을 잡은 상태에서 부른다.
+    // 빈 칸이 없으면 CALL_CHUNK 개를 새로 만든다. 이미 만든 칸은 옮기지 않으므로 포인터가 유지된다.
+
+    if (building->free_calls == NULL)
+    {
+        if ((long)(building->num_call_chunks + 1) * CALL_CHUNK > CALL_INDEX_MASK)
+        {
+            return NULL;
+        }
+        chunks = (Call **)realloc(building->call_chunks, sizeof(Call *) * (building->num_call_chunks + 1));
+        chunk = (Call *)malloc(sizeof(Call) * CALL_CHUNK);
+        if (chunks == NULL || chunk == NULL)
+        {
+            if (chunks != NULL)
+            {
+                building->call_chunks = chunks;
+            }
+            free(chunk);
+            return NULL;
+        }
+        building->call_chunks = chunks;
+        building->call_chunks[building->num_call_chunks] = chunk;
+        for (i = 0; i < CALL_CHUNK; i++)
+        {
+            chunk[i].id = CALL_GENERATION | (uint64_t)(building->num_call_chunks * CALL_CHUNK + i);
+            chunk[i].state = CALL_FREE;
+            call_push_free(building, &chunk[i]);
+        }
+        building->num_call_chunks++;
+    }
+
+    chunk = building->free_calls;
+    building->free_calls = chunk->next;
+    if (building->free_calls == NULL)
+    {
+        building->free_calls_tail = NULL;
+    }
+    building->num_calls++;
+    chunk->next = NULL;
+    chunk->state = CALL_QUEUED;
+    chunk->tag = 0;
+    chunk->reported = 0;
+    chunk->queued = NULL;
+    chunk->pickup = NULL;
+    return chunk;
+}
+
+void call_release(Building *building, Call *call)
+{
+    // 세대를 올려서 옛 번호로는 더 이상 찾지 못하게 한다(0 세대는 건너뛴다)
+    call->id += CALL_GENERATION;
+    if ((call->id >> CALL_INDEX_BITS) == 0)
+    {
+        call->id |= CALL_GENERATION;
+    }
+    call->state = CALL_FREE;
+    call->queued = NULL;
+    call->pickup = NULL;
+    building->num_calls--;
+    call_push_free(building, call);
+}
+
+void call_push_free(Building *building, Call *call)
+{
+    // 빈 칸 목록의 뒤에 붙인다.
+    // 방금 놓아준 칸을 바로 다시 쓰지 않고 모든 빈 칸을 돌아가며 쓰므로 칸마다 세대가 천천히 오른다.
+    call->next = NULL;
+    if (building->free_calls_tail != NULL)
+    {
+        building->free_calls_tail->next = call;
+    }
+    else
+    {
+        building->free_calls = call;
+    }
+    building->free_calls_tail = call;
+}
+
+Call *call_find(Building *building, uint64_t id)
+{
+    uint32_t index = (uint32_t)(id & CALL_INDEX_MASK);
+    Call *call;
+
+    if (index / CALL_CHUNK >= (uint32_t)building->num_call_chunks)
+    {
+        return NULL;
+    }
+    call = &building->call_chunks[index / CALL_CHUNK][index % CALL_CHUNK];
+    if (call->id != id || call->state == CALL_FREE)
+    {
+        return NULL;
+    }
+    return call;
+}
+
+void calls_reset(Building *building)
+{
+    Call *call;
+    int i;
+
+    // 쓰던 칸은 모두 놓아준다(재시작 전의 번호로는 찾지 못한다)
+    building->free_calls = NULL;
+    building->free_calls_tail = NULL;
+    for (i = 0; i < building->num_call_chunks * CALL_CHUNK; i++)
+    {
+        call = &building->call_chunks[i / CALL_CHUNK][i % CALL_CHUNK];
+        if (call->state != CALL_FREE)
+        {
+            call_release(building, call);
+        }
+        else
+        {
+            call_push_free(building, call);
+        }
+    }
+}
+
+void attach_calls(Call *calls, R_node *queued, F_node *pickup)
+{
+    // 호출들이 기다리는 요청이나 태우러 가는 정지 층을 바꾼다
+    for (; calls != NULL; calls = calls->next)
+    {
+        calls->state = queued != NULL ? CALL_QUEUED : CALL_ASSIGNED;
+        calls->queued = queued;
+        calls->pickup = pickup;
+    }
+}
+
+Call *join_calls(Call *calls, Call *more)
+{
+    Call *last;
+
+    // 먼저 부른 호출이 앞에 오도록 뒤에 붙인다(합쳐진 호출은 정원을 넘지 않는다)
+    if (calls == NULL)
+    {
+        return more;
+    }
+    for (last = calls; last->next != NULL; last = last->next)
+    {
+    }
+    last->next = more;
+    return calls;
+}
+
+Call *board_calls(Building *building, Call *calls, int boarded)
+{
+    Call *call;
+
+    // 먼저 부른 호출부터 태운 사람 수만큼 놓아주고 못 탄 호출들을 돌려준다.
+    // 마지막 호출은 일부만 탈 수 있다.
+
+    pthread_mutex_lock(&building->reqs_lock);
+    while (calls != NULL && calls->people <= boarded)
+    {
+        call = calls;
+        calls = calls->next;
+        boarded -= call->people;
+        call_release(building, call);
+    }
+    if (calls != NULL)
+    {
+        calls->people -= boarded;
+    }
+    pthread_mutex_unlock(&building->reqs_lock);
+    return calls;
+}
+
+void cancel_call(Building *building, Call *call)
+{
+    R_node *node = call->queued;
+    F_node *pickup = call->pickup;
+    Call **link;
+    int i;
+
+    // 두 잠금을 모두 잡은 상태에서 부른다.
+    // 1. 큐에서 기다리는 호출이면 요청에서 사람 수를 뺀다. 남은 사람이 없으면 요청을 지운다.
+    // 2. 태우러 가는 호출이면 태우는 층과 내리는 층에서 사람 수를 뺀다.
+    // 2-1. 남은 사람이 없으면 두 정지 층을 함께 지운다.
+
+    if (call->state == CALL_QUEUED)
+    {
+        for (link = &node->req.calls; *link != call; link = &(*link)->next)
+        {
+        }
+        *link = call->next;
+        node->req.num_people -= call->people;
+        if (node->req.num_people == 0)
+        {
+            if (building->queued[node->req.start_floor][node->req.dest_floor] == node)
+            {
+                building->queued[node->req.start_floor][node->req.dest_floor] = NULL;
+            }
+            R_list_unlink(node);
+            building->queue_size--;
+        }
+    }
+    else
+    {
+        for (link = &pickup->calls; *link != call; link = &(*link)->next)
+        {
+        }
+        *link = call->next;
+        pickup->people -= call->people;
+        if (pickup->pair != NULL)
+        {
+            pickup->pair->people += call->people;
+        }
+        if (pickup->people == 0)
+        {
+            if (pickup->pair != NULL)
+            {
+                for (i = 0; i < NUM_ELEVATORS; i++)
+                {
+                    if (building->elevators[i]->trips[pickup->floor][pickup->pair->floor] == pickup)
+                    {
+                        building->elevators[i]->trips[pickup->floor][pickup->pair->floor] = NULL;
+                    }
+                }
+                remove_stop(building, pickup->pair);
+            }
+            remove_stop(building, pickup);
+        }
+    }
+    call_release(building, call);
+}
+
+int valid_request(int current_floor, int dest_floor, int num_people)
+{
+    if (current_floor == dest_floor)
+    {
+        return 0;
+    }
+
+    if (current_floor > FLOOR || current_floor < 1 || dest_floor > FLOOR || dest_floor < 1)
+    {
+        return 0;
+    }
+
+    if (num_people < 1)
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+int dispatch_request(Building *building, Request *current)
+{
+    Elevator **elevators = building->elevators;
+    Elevator *response; // 요청에 응답하는 엘리베이터
+    int i;
+
+    // 같은 정지 층에 합칠 수 있으면 합친다
+    i = merge_into_trip(elevators, current);
+    if (i >= 0)
+    {
+        log_push(building->log, LOG_INFO, LOG_MERGE, building->id, building->ticks, i + 1, current->start_floor, current->dest_floor, current->num_people, 0);
+        return i;
+    }
+
+    response = find_elevator(building, current);
+    assign_request(response, current);
+
+    for (i = 0; i < NUM_ELEVATORS; i++)
+    {
+        if (elevators[i] == response)
+        {
+            break;
+        }
+    }
+    log_push(building->log, LOG_DEBUG, LOG_ASSIGN, building->id, building->ticks, i + 1, current->start_floor, current->dest_floor, current->num_people, 0);
+    return i;
+}
+
+void assign_request(Elevator *response, Request *current)
+{
+    F_node *location;   // 요청이 들어가는 위치
+    F_node *pickup;
+    F_node *dropoff;
+
+    // 요청에 응답하는 엘리베이터에 정보 추가하기
+
+    // 사람 태울 층 추가하기
+    location = find_ideal_location(response, current->start_floor, current->dest_floor, current->start_floor);
+    pickup = F_list_insert(response->pending, location, current->start_floor, current->num_people, current->call_time);
+
+    // 사람 내릴 층 추가하기
+    location = find_ideal_location(response, current->start_floor, current->dest_floor, current->dest_floor);
+    dropoff = F_list_insert(response->pending, location, current->dest_floor, current->num_people * -1, current->call_time);
+
+    pickup->pair = dropoff;
+    dropoff->pair = pickup;
+    pickup->calls = current->calls;
+    attach_calls(current->calls, NULL, pickup);
+    response->trips[current->start_floor][current->dest_floor] = pickup;
+    wake_elevator(response);
+}
+
+Elevator *find_elevator(Building *building, Request *current)
+{
+    Elevator **elevators = building->elevators;
+    int time_required[NUM_ELEVATORS];
+    int ideal_index;
+    int i;
+    int size;
+    int s;
+
+    // 1. 큐에 요청을 뺀다
+    // 2. 각각에 가상의 스케쥴링을 실행한다
+    // 2-1. 점검 요청이 들어와 있으면 소요시간을 최대로 한다
+    // 2-2. 엘리베이터가 만원인 경우에도 소요시간을 최대로 한다
+    // 3. 각각의 소요시간을 구한다
+    // 4. 최소 시간 걸리는 엘리베이터 리턴
+
+    candidate_range(current->start_floor, current->dest_floor, &s, &size);
+    for (i = 0; i < size; i++)
+    {
+        time_required[i] = pickup_time(elevators[i + s], current->start_floor, current->dest_floor);
+        if (time_required[i] != INT_MAX)
+        {
+            log_push(building->log, LOG_DEBUG, LOG_CANDIDATE, building->id, building->ticks, i + s + 1, time_required[i], 0, 0, 0);
+        }
+    }
+
+    ideal_index = find_min(time_required, size);
+    return elevators[ideal_index + s];
+}
+
+int route_of(int start_floor, int dest_floor)
+{
+    int first, count;
+
+    // 후보 엘리베이터(candidate_range)가 같은 요청끼리 같은 큐에 넣는다
+    candidate_range(start_floor, dest_floor, &first, &count);
+    if (first == 0)
+    {
+        return 0;
+    }
+    return count == 2 ? 1 : 2;
+}
+
+void candidate_range(int start_floor, int dest_floor, int *first, int *count)
+{
+    //엘리베이터 : 1, 2 - 저층, 3, 4 - 전층, 5, 6 - 고층
+    if ((start_floor > 10 && dest_floor <= 10) || (start_floor <= 10 && dest_floor > 10))
+    {
+        *first = 2;
+        *count = 2;
+    }
+    else if (start_floor > 10 || dest_floor > 10)
+    {
+        *first = 2;
+        *count = 4;
+    }
+    else
+    {
+        *first = 0;
+        *count = 4;
+    }
+}
+
+int pickup_time(Elevator *elevator, int start_floor, int dest_floor)
+{
+    F_node *ideal;
+
+    // 점검 요청이 들어와 있거나 만원이거나 일정이 밀려 있으면 소요시간을 최대로 한다
+    if (!accepting(elevator))
+    {
+        return INT_MAX;
+    }
+    ideal = find_ideal_location(elevator, start_floor, dest_floor, start_floor);
+    return busy_time(elevator) + find_time(elevator->pending, ideal, elevator->current_floor, start_floor, elevator->current_people);
+}
+
+int accepting(Elevator *elevator)
+{
+    // 새 정지 층을 배정받을 수 있는지.
+    // 남은 일정이 MAX_SCHEDULE 을 넘으면 받지 않아서 밀린 호출이 엘리베이터 대신 큐에 쌓이게 한다.
+    return in_service(elevator) && elevator->current_people < MAX_PEOPLE && schedule_time(elevator) < MAX_SCHEDULE;
+}
+
+int schedule_time(Elevator *elevator)
+{
+    F_list list = elevator->pending;
+
+    // 남은 정지 층을 모두 들르는 데 걸리는 시간(남은 승하차, 수리 시간 포함)
+    if (F_list_peek(list) == list.tail)
+    {
+        return busy_time(elevator);
+    }
+    return busy_time(elevator) + find_time(list, list.tail, elevator->current_floor, list.tail->prev->floor, elevator->current_people);
+}
+
+void rebalance(Building *building)
+{
+    Elevator *elevator;
+    F_node *curr, *next;
+    int budget = REBALANCE_PER_TICK;
+    int index;
+    int i;
+
+    // 1. 엘리베이터를 하나씩 돌아가며 아직 태우지 않은 호출을 검사한다.
+    // 1-1. 지난 1초에 검사하다 멈춘 정지 층부터 이어서 검사한다(remove_stop 이 지워지는 위치를 옮긴다).
+    // 2. 지금 엘리베이터가 도착할 시간과 다른 엘리베이터가 도착할 시간을 비교한다.
+    // 3. REBALANCE_MARGIN 이상 빨라지면 태우는 층과 내리는 층을 함께 옮긴다(호출마다 한 번만).
+    // 지나가는 정지 층마다 하나씩 세서 1초에 REBALANCE_PER_TICK 개 까지만 본다.
+    // 도착 시간은 바뀐 만큼만 계산하지 않고 검사할 때마다 처음부터 다시 계산한다.
+
+    for (i = 0; i < NUM_ELEVATORS && budget > 0; i++)
+    {
+        index = building->rebalance_car;
+        elevator = building->elevators[index];
+
+        curr = elevator->rebalance_at != NULL ? elevator->rebalance_at : elevator->pending.head->next;
+        while (curr != elevator->pending.tail && budget > 0)
+        {
+            next = curr->next;
+            budget--;
+            // 아직 태우지 않은 태우는 층은 항상 내리는 층과 짝이 있다
+            // (내리는 층이 먼저 오면 move_elevator 가 태우는 층 뒤로 옮긴다)
+            if (curr->people > 0 && !curr->moved)
+            {
+                // 옮기면 바로 뒤의 짝도 함께 지워진다
+                if (next == curr->pair)
+                {
+                    next = next->next;
+                }
+                if (rebalance_trip(building, index, curr))
+                {
+                    building->rebalanced++;
+                }
+            }
+            curr = next;
+        }
+
+        // 끝까지 검사했으면 다음 엘리베이터로, 아니면 다음 1초에 이어서 검사한다
+        if (curr == elevator->pending.tail)
+        {
+            elevator->rebalance_at = NULL;
+            building->rebalance_car = (index + 1) % NUM_ELEVATORS;
+        }
+        else
+        {
+            elevator->rebalance_at = curr;
+        }
+    }
+}
+
+int rebalance_trip(Building *building, int index, F_node *pickup)
+{
+    Elevator *elevator = building->elevators[index];
+    Request req;
+    Call *call;
+    int current_time; // 지금 엘리베이터가 태우러 가는 데 걸리는 시간
+    int time;
+    int best = -1;
+    int best_time;
+    int s, size, i;
+
+    assert(pickup->pair != NULL);
+    current_time = busy_time(elevator) + find_time(elevator->pending, pickup, elevator->current_floor, pickup->floor, elevator->current_people);
+    best_time = current_time - REBALANCE_MARGIN;
+
+    candidate_range(pickup->floor, pickup->pair->floor, &s, &size);
+    for (i = s; i < s + size; i++)
+    {
+        if (i == index)
+        {
+            continue;
+        }
+        time = pickup_time(building->elevators[i], pickup->floor, pickup->pair->floor);
+        if (time < best_time)
+        {
+            best = i;
+            best_time = time;
+        }
+    }
+    if (best < 0)
+    {
+        return 0;
+    }
+
+    req.start_floor = pickup->floor;
+    req.dest_floor = pickup->pair->floor;
+    req.num_people = pickup->people;
+    req.call_time = pickup->call_time;
+    req.queue_time = building->ticks;
+    req.calls = pickup->calls;
+
+    if (elevator->trips[req.start_floor][req.dest_floor] == pickup)
+    {
+        elevator->trips[req.start_floor][req.dest_floor] = NULL;
+    }
+    remove_stop(building, pickup->pair);
+    remove_stop(building, pickup);
+
+    // 이미 알려준 호출도 바뀐 엘리베이터를 다시 알린다(합쳐지기 전에 표시해둔다)
+    for (call = req.calls; call != NULL; call = call->next)
+    {
+        call->reported = 0;
+    }
+    assign_request(building->elevators[best], &req);
+    // 옮긴 호출이 엘리베이터 사이를 오가지 않도록 한 번만 옮긴다
+    building->elevators[best]->trips[req.start_floor][req.dest_floor]->moved = 1;
+    report_assign(building, &req, best);
+    log_push(building->log, LOG_INFO, LOG_REBALANCE, building->id, building->ticks, index + 1, best + 1, req.start_floor, req.dest_floor, current_time - best_time);
+    return 1;
+}
+
+F_node *find_scheduled_place(F_node *start, F_node *end, int start_floor, int dest_floor, int target)
+{
+    F_node *current = start;
+    int call_direction = dest_floor - start_floor;
+    if (call_direction > 0)
+    {
+        while (1)
+        {
+            if(current->next == NULL)
+            {
+                return current;
+            }
+            if(current == end->next)
+            {
+                return current;
+            }
+            if(target < current->floor)
+            {
+                return current;
+            }
+            current = current->next;
+        }
+    }
+    else
+    {
+        while (1)
+        {
+            if(current->next == NULL)
+            {
+                return current;
+            }
+            if(current == end->next)
+            {
+                return current;
+            }
+            if(target > current->floor)
+            {
+                return current;
+            }
+            current = current->next;
+        }
+    }
+}
+
+F_node *find_direction_change_location(F_node *current, int current_direction)
+{
+    int new_direction;
+    F_node *target = current;
+
+    while (1)
+    {
+        if(target->next == NULL)
+        {
+            return target;
+        }
+        else if(target->next->next == NULL)
+        {
+            return target->next;
+        }
+
+        new_direction = target->next->floor - target->floor;
+        if(new_direction * current_direction < 0)
+        {
+            return target;
+        }
+
+        target = target->next;
+    }
+}
+
+F_node *find_ideal_location(Elevator *elevator, int start_floor, int dest_floor, int target)
+{
+    int elevator_direction = 0;
+    int call_direction = 0;
+    F_list list = elevator->pending;
+    F_node *start = list.head->next;
+    F_node *end;
+
+    if (start == list.tail)
+    {
+        return start;
+    }
+
+    elevator_direction = start->floor - elevator->current_floor;
+    if(elevator_direction == 0)
+    {
+        if(start->next == list.tail)
+        {
+            return start->next;
+        }
+        else
+        {
+            elevator_direction = start->next->floor - start->floor;
+        }
+    }
+
+    call_direction = dest_floor - start_floor;
+
+    if (call_direction > 0)
+    {
+        if (elevator_direction > 0)
+        {
+            if (target >= elevator->current_floor)
+            {
+                end = find_direction_change_location(start, elevator_direction);
+                return find_scheduled_place(start, end, start_floor, dest_floor, target);
+            }
+            else
+            {
+                // 다음 방향 같아질 때 까지 찾아야 함!
+                start = find_direction_change_location(start, elevator_direction);
+                elevator_direction *= -1;
+                start = find_direction_change_location(start, elevator_direction);
+                elevator_direction *= -1;
+                end = find_direction_change_location(start, elevator_direction);
+                return find_scheduled_place(start, end, start_floor, dest_floor, target);
+            }
+        }
+        else
+        {
+            // 다음 방향 바뀔 때 까지 찾아야 함!
+            start = find_direction_change_location(start, elevator_direction);
+            elevator_direction *= -1;
+            end = find_direction_change_location(start, elevator_direction);
+            return find_scheduled_place(start, end, start_floor, dest_floor, target);
+        }
+    }
+    else
+    {
+        if (elevator_direction < 0)
+        {
+            if (target <= elevator->current_floor)
+            {
+                end = find_direction_change_location(start, elevator_direction);
+                return find_scheduled_place(start, end, start_floor, dest_floor, target);
+            }
+            else
+            {
+                // 다음 방향 같아질 때 까지 찾아야 함!
+                start = find_direction_change_location(start, elevator_direction);
+                elevator_direction *= -1;
+                start = find_direction_change_location(start, elevator_direction);
+                elevator_direction *= -1;
+                end = find_direction_change_location(start, elevator_direction);
+                return find_scheduled_place(start, end, start_floor, dest_floor, target);
+            }
+        }
+        else
+        {
+            // 다음 방향 바뀔 때 까지 찾아야 함!
+            start = find_direction_change_location(start, elevator_direction);
+            elevator_direction *= -1;
+            end = find_direction_change_location(start, elevator_direction);
+            return find_scheduled_place(start, end, start_floor, dest_floor, target);
+        }
+    }
+}
+
+int find_time(F_list list, F_node *target, int start, int end, int load)
+{
+    int time = 0;
+    F_node *curr = list.head->next;
+
+    // load : 각 정지 층에 도착했을 때 탑승 중인 사람 수(예상)
+
+    if(curr == target)
+    {
+        time += abs(end - start);
+        return time;
+    }
+
+    if (curr->next == NULL)
+    {
+        time += abs(end - start);
+        return time;
+    }
+
+    time += abs(curr->floor - start);
+    time += stop_time(curr->people, &load);
+
+    while (curr->next != target)
+    {
+        time += abs(curr->next->floor - curr->floor);
+        time += stop_time(curr->next->people, &load);
+        curr = curr->next;
+    }
+    time += abs(end - curr->floor);
+    return time;
+}
+
+int board_time(int people)
+{
+    // 승객 3명당 1초, 최소 1초는 멈춘다
+    int time = (abs(people) + BOARD_RATE - 1) / BOARD_RATE;
+    return time > 0 ? time : 1;
+}
+
+int stop_time(int people, int *load)
+{
+    int available;
+
+    // 내리는 경우
+    if (people <= 0)
+    {
+        *load += people;
+        return board_time(people);
+    }
+
+    // 태우는 경우, 정원이 초과되면 태울 수 있는 만큼만 태우고 1초 추가
+    available = MAX_PEOPLE - *load;
+    if (people <= available)
+    {
+        *load += people;
+        return board_time(people);
+    }
+    *load = MAX_PEOPLE;
+    return board_time(available) + FULL_PENALTY;
+}
+
+int find_min(int *arr, int n)
+{
+    // 우선순위 규칙
+    // 1. 시간이 최소로 걸리는 엘리베이터
+    // 2. 운행 범위가 좁은 엘리베이터(저층 > 전층)
+    // 3. 현재 사람 수가 적은 엘리베이터(이미 만원인 엘리베이터는 제외)
+    // 4. 인덱스가 적은 엘리베이터
+
+    int i;
+    int min = 0;
+    for (i = 1; i < n; i++)
+    {
+        if (arr[i] < arr[min])
+        {
+            min = i;
+        }
+    }
+    //추가 우선순위에 대한 고려 필요
+    return min;
+}
+
+void move_elevator(Building *building)
+{
+    Elevator **elevators = building->elevators;
+    int i;
+    int available;   // 정원이 초과될 시 최대로 태울수 있는 사람 수
+    int leftover;    // 못 타고 남아있는 사람 수
+    int call_time;   // 남은 사람들의 호출 시각
+    int dwell;       // 이번 1초를 제외한 승하차 시간
+    F_node *next_floor;
+    F_node *pair;    // 태우는 층과 짝인 내리는 층
+    F_node *after;   // 다음 정지 층을 미뤄서 옮길 위치
+    Call *calls;     // 못 타고 남은 호출들
+
+    // 1. 다음 목적지를 구한다(있으면).
+    // 1-1. 수리 요청인 경우 수리에 들어간다.
+    // 1-2. 아직 태우지 않은 호출의 내리는 층이면 태우는 층 뒤로 미룬다.
+    // 1-3. 만원인데 태우는 층이면 가장 가까운 내리는 층 뒤로 미룬다.
+    // 2. 현재 층과 비교하여,
+    // 3. 높으면 현재층 증가, 낮으면 감소, 같으면 사람을 태운다.
+    // 4. 사람을 다 못 태우면 최대 수용 가능 인원만 태운다.
+    // 4-1. 다 못 타고 남은 인원은 다시 엘리베이터를 호출한다.
+    // 5. 승하차 중이면 승하차 시간이 끝날 때 까지 멈춘다.
+    // 6. 할 일이 없으면 수요가 많을 것으로 예상되는 층으로 가서 기다린다.
+    // 수리, 승하차, 대기 중인 엘리베이터는 타이머가 깨울 때 까지 건너뛴다.
+
+    for (i = 0; i < NUM_ELEVATORS; i++)
+    {
+        if (!elevators[i]->awake)
+        {
+            continue;
+        }
+
+        if (F_list_peek(elevators[i]->pending) != elevators[i]->pending.tail)
+        {
+            elevators[i]->idle_since = -1;
+            elevators[i]->park_floor = 0;
+            next_floor = F_list_peek(elevators[i]->pending);
+            while (1)
+            {
+                // 태우기 전에 내리는 층이 먼저 오면 내릴 사람이 없으므로 태우는 층 바로 뒤로 옮긴다
+                if (next_floor->people < 0 && next_floor->pair != NULL)
+                {
+                    after = next_floor->pair;
+                }
+                // 만원이면 태우는 층을 건너뛰고 가장 가까운 내리는 층까지 간다
+                else if (next_floor->people > 0 && elevators[i]->current_people >= MAX_PEOPLE)
+                {
+                    after = find_dropoff(elevators[i]);
+                }
+                else
+                {
+                    break;
+                }
+                if (after == NULL)
+                {
+                    break;
+                }
+                F_list_move(next_floor, after);
+                next_floor = F_list_peek(elevators[i]->pending);
+            }
+            if (next_floor->floor == -1)
+            {
+                elevators[i]->fix = 1;
+                remove_stop(building, next_floor);
+                // 다음 1초부터 FIX_TIME 동안 수리한다
+                elevators[i]->awake = 0;
+                timer_add(&building->wheel, &elevators[i]->timer, TIMER_FIX, building->ticks + FIX_TIME + 1);
+            }
+            else
+            {
+                if (elevators[i]->next_dest != next_floor->floor)
+                {
+                    elevators[i]->next_dest = next_floor->floor;
+                }
+
+                if (elevators[i]->next_dest > elevators[i]->current_floor)
+                {
+                    (elevators[i]->current_floor)++;
+                }
+                else if (elevators[i]->next_dest < elevators[i]->current_floor)
+                {
+                    (elevators[i]->current_floor)--;
+                }
+                else
+                {
+                    if (elevators[i]->current_floor == next_floor->floor)
+                    {
+                        available = MAX_PEOPLE - elevators[i]->current_people;
+                        // forget_trip 이 짝을 지우기 전에 내리는 층을 기억한다
+                        pair = next_floor->pair;
+                        forget_trip(elevators[i], next_floor);
+                        if (next_floor->people <= available)
+                        {
+                            elevators[i]->current_people += next_floor->people;
+                            if (next_floor->people > 0)
+                            {
+                                elevators[i]->total_people += next_floor->people;
+                                record_wait(building, building->ticks - next_floor->call_time, next_floor->people);
+                                record_floor_demand(building, next_floor->floor, pair->floor, next_floor->people);
+                            }
+                            // 승하차 하는 이번 1초를 제외한 나머지 시간
+                            dwell = board_time(next_floor->people) - 1;
+                            board_calls(building, next_floor->calls, next_floor->people);
+                            remove_stop(building, next_floor);
+                        }
+                        else
+                        {
+                            elevators[i]->current_people += available;
+                            elevators[i]->total_people += available;
+                            record_wait(building, building->ticks - next_floor->call_time, available);
+                            record_floor_demand(building, next_floor->floor, pair->floor, available);
+                            leftover = next_floor->people - available;
+                            log_push(building->log, LOG_INFO, LOG_FULL, building->id, building->ticks, i + 1, next_floor->floor, available, leftover, 0);
+                            dwell = board_time(available) + FULL_PENALTY - 1;
+                            call_time = next_floor->call_time;
+                            calls = board_calls(building, next_floor->calls, available);
+                            remove_stop(building, next_floor);
+
+                            // 태우는 층에 먼저 도착하므로(F_list_move) 내리는 층과의 짝이 남아있다
+                            assert(pair != NULL);
+                            pair->people = available * -1;
+
+                            insert_into_queue(building, elevators[i]->current_floor, calls->dest_floor, leftover, call_time, calls);
+                        }
+                        if (dwell > 0)
+                        {
+                            elevators[i]->awake = 0;
+                            timer_add(&building->wheel, &elevators[i]->timer, TIMER_DWELL, building->ticks + dwell + 1);
+                        }
+                    }
+                }
+            }
+        }
+        else
+        {
+            park_elevator(building, i);
+        }
+    }
+}
+
+F_node *find_dropoff(Elevator *elevator)
+{
+    F_node *curr;
+
+    // 이미 탄 사람이 내리는 가장 가까운 정지 층(태우는 층과의 짝이 지워져 있다)
+    for (curr = elevator->pending.head->next; curr != elevator->pending.tail; curr = curr->next)
+    {
+        if (curr->people < 0 && curr->pair == NULL)
+        {
+            return curr;
+        }
+    }
+    return NULL;
+}
+
+int zone_of(int index)
+{
+    //엘리베이터 : 1, 2 - 저층, 3, 4 - 전층, 5, 6 - 고층
+    return index / 2;
+}
+
+int in_service(Elevator *elevator)
+{
+    // 수리 중이거나 점검 요청이 들어가 있으면 호출에 응하지 않는다
+    return !elevator->fix && elevator->pending.tail->prev->floor != -1;
+}
+
+double car_capacity(int index)
+{
+    int span; // 운행 범위의 층 수
+
+    // 정원을 채워 운행 범위 끝에서 끝까지 한 번 오가는 동안 실어 나르는 승객 수(초당)
+    span = zone_of(index) == 1 ? FLOOR - 1 : FLOOR / 2 - 1;
+    return (double)MAX_PEOPLE / (2 * span + 2 * board_time(MAX_PEOPLE));
+}
+
+void schedule_maintenance(Building *building)
+{
+    Elevator **elevators = building->elevators;
+    int i, j;
+    int others; // 같은 구역에서 운행 중인 다른 엘리베이터 수
+    int total;
+    int tolerance = building->maint_tolerance;
+    int format; // 일지에 남기는 점검 사유
+
+    // 1. 점검 기준에 가까운 엘리베이터를 찾는다.
+    // 2. 같은 구역에 운행 중인 엘리베이터가 부족하면 점검을 미룬다.
+    // 2-1. 허용 범위를 넘으면 미루지 않고 점검한다.
+    // 3. 여유가 있고 남는 엘리베이터로 충분할 만큼 수요가 적으면 점검을 앞당긴다.
+    // 점검 시점이 구역 안에서 엇갈리게 되어 구역 전체가 멈추지 않는다.
+
+    for (i = 0; i < NUM_ELEVATORS; i++)
+    {
+        total = elevators[i]->total_people;
+        if (!in_service(elevators[i]) || total < MAX_TOTAL - tolerance)
+        {
+            continue;
+        }
+
+        format = LOG_MAINT;
+        others = 0;
+        for (j = 0; j < NUM_ELEVATORS; j++)
+        {
+            if (j != i && zone_of(j) == zone_of(i) && in_service(elevators[j]))
+            {
+                others++;
+            }
+        }
+
+        if (others < building->min_in_service)
+        {
+            if (total >= MAX_TOTAL + tolerance)
+            {
+                building->maint_forced++;
+                format = LOG_MAINT_FORCED;
+            }
+            else
+            {
+                if (total >= MAX_TOTAL && !elevators[i]->deferred)
+                {
+                    elevators[i]->deferred = 1;
+                    building->maint_deferred++;
+                    log_push(building->log, LOG_INFO, LOG_MAINT_DEFER, building->id, building->ticks, i + 1, total, 0, 0, 0);
+                }
+                continue;
+            }
+        }
+        else if (total < MAX_TOTAL)
+        {
+            if (building->demand[zone_of(i)] >= others * car_capacity(i) * DEMAND_LOW)
+            {
+                continue;
+            }
+            building->maint_advanced++;
+            format = LOG_MAINT_EARLY;
+        }
+
+        F_list_insert(elevators[i]->pending, elevators[i]->pending.tail, -1, 0, building->ticks);
+        wake_elevator(elevators[i]);
+        log_push(building->log, LOG_INFO, format, building->id, building->ticks, i + 1, total, 0, 0, 0);
+        elevators[i]->total_people = 0;
+        elevators[i]->deferred = 0;
+    }
+}
+
+void update_demand(Building *building)
+{
+    int z;
+    for (z = 0; z < NUM_ZONES; z++)
+    {
+        building->demand[z] = building->demand[z] * (1 - DEMAND_WEIGHT) + building->zone_calls[z] * DEMAND_WEIGHT;
+        building->zone_calls[z] = 0;
+    }
+}
+
+void record_wait(Building *building, int wait, int people)
+{
+    record_wait_hist(building->wait_hist, wait, people);
+    building->hist_version++;
+}
+
+void record_wait_hist(int *hist, int wait, int people)
+{
+    if (wait > MAX_WAIT)
+    {
+        wait = MAX_WAIT;
+    }
+    hist[wait] += people;
+}
+
+int wait_percentile(int *wait_hist, int percent)
+{
+    int i;
+    long total = 0;
+    long sum = 0;
+
+    for (i = 0; i <= MAX_WAIT; i++)
+    {
+        total += wait_hist[i];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    for (i = 0; i <= MAX_WAIT; i++)
+    {
+        sum += wait_hist[i];
+        if (sum * 100 >= total * percent)
+        {
+            return i;
+        }
+    }
+    return MAX_WAIT;
+}
+
+int wait_average(int *wait_hist)
+{
+    long total = 0;
+    long sum = 0;
+    int i;
+
+    for (i = 0; i <= MAX_WAIT; i++)
+    {
+        total += wait_hist[i];
+        sum += (long)wait_hist[i] * i;
+    }
+    return total ? sum / total : 0;
+}
+
+void record_floor_demand(Building *building, int floor, int dest_floor, int people)
+{
+    int slot = building->ticks % DAY_TICKS / SLOT_TICKS;
+    int first, count;
+    int i;
+
+    // 새 시간대에 들어서면 그 시간대의 지난 기록을 반으로 줄여서
+    // 최근 며칠의 수요가 더 크게 반영되도록 한다
+    if (slot != building->demand_slot)
+    {
+        int z, f;
+        for (z = 0; z < NUM_ZONES; z++)
+        {
+            for (f = 1; f <= FLOOR; f++)
+            {
+                building->floor_demand[slot][z][f] /= 2;
+            }
+        }
+        building->demand_slot = slot;
+    }
+
+    // 이 호출을 배정받을 수 있는 구역에만 수요로 기록한다
+    candidate_range(floor, dest_floor, &first, &count);
+    for (i = first; i < first + count; i += 2)
+    {
+        building->floor_demand[slot][zone_of(i)][floor] += people;
+    }
+}
+
+void park_elevator(Building *building, int index)
+{
+    Elevator *elevator = building->elevators[index];
+
+    // 1. 할 일이 없어진 시각을 기록하고 PARK_DELAY 뒤에 깨우는 타이머를 건다.
+    // 2. 타이머가 깨우면 대기할 층을 정한다(timer_expire).
+    // 3. 대기할 층까지 1초에 1층씩 이동하고, 도착하면 호출이 올 때 까지 쉰다.
+    // 호출이 들어오면 wake_elevator 와 move_elevator 에서 타이머와 대기 층을 지운다.
+
+    if (elevator->idle_since < 0)
+    {
+        elevator->idle_since = building->ticks;
+        elevator->awake = 0;
+        timer_add(&building->wheel, &elevator->timer, TIMER_PARK, building->ticks + PARK_DELAY);
+        return;
+    }
+
+    elevator->next_dest = elevator->park_floor;
+    if (elevator->park_floor > elevator->current_floor)
+    {
+        (elevator->current_floor)++;
+    }
+    else if (elevator->park_floor < elevator->current_floor)
+    {
+        (elevator->current_floor)--;
+    }
+    if (elevator->park_floor == elevator->current_floor)
+    {
+        elevator->awake = 0;
+    }
+}
+
+int find_park_floor(Building *building, int index)
+{
+    Elevator *elevator = building->elevators[index];
+    Elevator *other;
+    int slot = building->ticks % DAY_TICKS / SLOT_TICKS;
+    int next_slot = (slot + 1) % NUM_SLOTS;
+    int best = elevator->current_floor;
+    int best_score = 0;
+    int score;
+    int taken;
+    int f, j;
+
+    // 지금 시간대와 다음 시간대에, 이 엘리베이터가 배정받을 수 있는 호출로 탑승이 가장 많았던 층을 고른다.
+    // 같은 구역의 다른 엘리베이터가 이미 대기 중인 층은 제외한다.
+    // 수요가 같으면 가까운 층을 고른다.
+
+    for (f = 1; f <= FLOOR; f++)
+    {
+        if (!serves_floor(index, f))
+        {
+            continue;
+        }
+
+        taken = 0;
+        for (j = 0; j < NUM_ELEVATORS; j++)
+        {
+            other = building->elevators[j];
+            if (j == index || zone_of(j) != zone_of(index) || other->idle_since < 0)
+            {
+                continue;
+            }
+            if (other->park_floor == f || (other->park_floor == 0 && other->current_floor == f))
+            {
+                taken = 1;
+            }
+        }
+        if (taken)
+        {
+            continue;
+        }
+
+        score = building->floor_demand[slot][zone_of(index)][f] + building->floor_demand[next_slot][zone_of(index)][f];
+        if (score > best_score || (score == best_score && score > 0 && abs(f - elevator->current_floor) < abs(best - elevator->current_floor)))
+        {
+            best = f;
+            best_score = score;
+        }
+    }
+
+    return best;
+}
+
+int serves_floor(int index, int floor)
+{
+    int first, count;
+    int dest;
+
+    // 이 층에서 타는 호출 중 이 엘리베이터에 배정될 수 있는 것이 있는지(candidate_range 기준).
+    // 고층용은 1층에 설 수 있지만 1층에서 타는 호출은 배정받지 않으므로 1층은 제외된다.
+    for (dest = 1; dest <= FLOOR; dest++)
+    {
+        if (dest == floor)
+        {
+            continue;
+        }
+        candidate_range(floor, dest, &first, &count);
+        if (index >= first && index < first + count)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void wake_elevator(Elevator *elevator)
+{
+    // 대기 중이던 엘리베이터에 할 일이 생기면 바로 움직인다.
+    // 수리나 승하차 중이면 타이머가 끝날 때 깨운다.
+    if (elevator->timer.next != NULL && elevator->timer.kind != TIMER_PARK)
+    {
+        return;
+    }
+    timer_cancel(&elevator->timer);
+    elevator->awake = 1;
+}
+
+int busy_time(Elevator *elevator)
+{
+    // 수리나 승하차가 끝날 때 까지 남은 시간
+    if (elevator->timer.kind == TIMER_PARK)
+    {
+        return 0;
+    }
+    return timer_left(&elevator->timer);
+}
+
+void wheel_init(Wheel *wheel)
+{
+    int level, slot;
+
+    wheel->now = 0;
+    for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+        for (slot = 0; slot < WHEEL_SIZE; slot++)
+        {
+            wheel->slots[level][slot].next = &wheel->slots[level][slot];
+            wheel->slots[level][slot].prev = &wheel->slots[level][slot];
+        }
+    }
+}
+
+void wheel_insert(Wheel *wheel, Timer *timer, int base)
+{
+    long delta = (long)timer->expires - base; // base : 다음에 처리할 시각
+    long place = timer->expires;
+    int level = 0;
+    Timer *head;
+
+    // 남은 시간이 64^(level+1) 보다 작은 가장 낮은 단계에 건다.
+    // 바퀴가 담을 수 있는 것보다 먼 타이머는 맨 위 단계의 끝에 걸어두고
+    // 내려올 때 다시 건다.
+    while (level < WHEEL_LEVELS - 1 && delta >= 1L << (WHEEL_BITS * (level + 1)))
+    {
+        level++;
+    }
+    if (delta >= 1L << (WHEEL_BITS * WHEEL_LEVELS))
+    {
+        place = base + (1L << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+    }
+
+    head = &wheel->slots[level][(place >> (WHEEL_BITS * level)) & WHEEL_MASK];
+    timer->next = head;
+    timer->prev = head->prev;
+    head->prev->next = timer;
+    head->prev = timer;
+    timer->wheel = wheel;
+}
+
+void wheel_advance(Building *building)
+{
+    Wheel *wheel = &building->wheel;
+    int tick = wheel->now + 1;
+    int level;
+    Timer list;
+    Timer *head, *timer;
+
+    // 1. 아래 단계가 한 바퀴 돌았으면 위 단계의 칸을 아래로 내린다.
+    // 2. 현재 시각 칸에 걸린 타이머를 모두 끝낸다.
+    // 타이머 하나당 내리는 횟수는 단계 수를 넘지 않는다.
+
+    for (level = 1; level < WHEEL_LEVELS; level++)
+    {
+        if ((tick >> (WHEEL_BITS * (level - 1))) & WHEEL_MASK)
+        {
+            break;
+        }
+        head = &wheel->slots[level][(tick >> (WHEEL_BITS * level)) & WHEEL_MASK];
+        while (head->next != head)
+        {
+            timer = head->next;
+            timer_cancel(timer);
+            wheel_insert(wheel, timer, tick);
+        }
+    }
+    wheel->now = tick;
+
+    // 끝나는 동안 새로 걸리는 타이머와 섞이지 않게 칸을 통째로 떼어낸다
+    head = &wheel->slots[0][tick & WHEEL_MASK];
+    if (head->next == head)
+    {
+        return;
+    }
+    list.next = head->next;
+    list.prev = head->prev;
+    list.next->prev = &list;
+    list.prev->next = &list;
+    head->next = head;
+    head->prev = head;
+
+    while (list.next != &list)
+    {
+        timer = list.next;
+        timer_cancel(timer);
+        timer_expire(building, timer);
+    }
+}
+
+void timer_add(Wheel *wheel, Timer *timer, int kind, int expires)
+{
+    timer_cancel(timer);
+    timer->kind = kind;
+    timer->expires = expires > wheel->now ? expires : wheel->now + 1;
+    wheel_insert(wheel, timer, wheel->now + 1);
+}
+
+void timer_cancel(Timer *timer)
+{
+    if (timer->next == NULL)
+    {
+        return;
+    }
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = NULL;
+    timer->prev = NULL;
+}
+
+int timer_left(Timer *timer)
+{
+    if (timer->next == NULL)
+    {
+        return 0;
+    }
+    return timer->expires - timer->wheel->now;
+}
+
+void timer_expire(Building *building, Timer *timer)
+{
+    Elevator *elevator = building->elevators[timer->owner];
+
+    switch (timer->kind)
+    {
+    case TIMER_FIX:
+        elevator->fix = 0;
+        log_push(building->log, LOG_INFO, LOG_REPAIRED, building->id, building->ticks, timer->owner + 1, 0, 0, 0, 0);
+        break;
+    case TIMER_PARK:
+        elevator->park_floor = find_park_floor(building, timer->owner);
+        break;
+    }
+    elevator->awake = 1;
+}
+
+void R_list_init(R_list *list)
+{
+    list->head = (R_node *)malloc(sizeof(R_node));
+    list->tail = (R_node *)malloc(sizeof(R_node));
+    list->head->prev = NULL;
+    list->head->next = list->tail;
+    list->tail->prev = list->head;
+    list->tail->next = NULL;
+}
+
+void R_list_clear(R_list list)
+{
+    R_node *curr = list.head->next;
+    R_node *temp;
+
+    while (curr != list.tail)
+    {
+        temp = curr;
+        curr = curr->next;
+        free(temp);
+    }
+    list.head->next = list.tail;
+    list.tail->prev = list.head;
+}
+
+R_node *R_list_insert(R_list list, Request *req)
+{
+    R_node *new_node = (R_node *)malloc(sizeof(R_node));
+    new_node->next = list.tail;
+    new_node->prev = new_node->next->prev;
+    new_node->prev->next = new_node;
+    new_node->next->prev = new_node;
+    new_node->req = *req;
+    return new_node;
+}
+
+Request R_list_unlink(R_node *to_remove)
+{
+    Request ret = to_remove->req;
+
+    to_remove->prev->next = to_remove->next;
+    to_remove->next->prev = to_remove->prev;
+    to_remove->next = NULL;
+    to_remove->prev = NULL;
+
+    free(to_remove);
+    return ret;
+}
+
+F_node *F_list_insert(F_list list, F_node *after, int floor, int people, int call_time)
+{
+    F_node *new_node = (F_node *)malloc(sizeof(F_node));
+    new_node->next = after;
+    new_node->prev = new_node->next->prev;
+    new_node->next->prev = new_node;
+    new_node->prev->next = new_node;
+    new_node->floor = floor;
+    new_node->people = people;
+    new_node->call_time = call_time;
+    new_node->pair = NULL;
+    new_node->calls = NULL;
+    new_node->moved = 0;
+    return new_node;
+}
+
+int F_list_size(F_list list)
+{
+    F_node *curr = list.head->next;
+    int num = 0;
+
+    while (curr != list.tail)
+    {
+        num++;
+        curr = curr->next;
+    }
+
+    return num;
+}
+
+void F_list_remove(F_list list)
+{
+    F_node *to_remove = list.head->next;
+
+    to_remove->prev->next = to_remove->next;
+    to_remove->next->prev = to_remove->prev;
+    to_remove->next = NULL;
+    to_remove->prev = NULL;
+
+    free(to_remove);
+}
+
+void F_list_unlink(F_node *node)
+{
+    // 정지 층을 지운다(시뮬레이션 중에는 재배정 검사 위치를 옮기는 remove_stop 으로 부른다)
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = NULL;
+    node->prev = NULL;
+
+    free(node);
+}
+
+void F_list_move(F_node *node, F_node *prev)
+{
+    // 정지 층을 prev 바로 뒤로 옮긴다
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->prev = prev;
+    node->next = prev->next;
+    prev->next->prev = node;
+    prev->next = node;
+}
+
+F_node *F_list_peek(F_list list)
+{
+    return list.head->next;
+}
@@ -0,0 +1,100 @@
+#ifndef ELEVATOR_LOG_H
+#define ELEVATOR_LOG_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+/* 운행 일지 기록 링 버퍼
+ * 시뮬레이션은 건물마다 링 하나에 기록을 쌓고, 다른 스레드 하나가 꺼내서 글로 바꾼다.
+ * 건물은 한 번에 한 스레드만 진행하므로 쓰는 쪽도 하나뿐이라 잠금이 필요 없다(SPSC).
+ * 기록은 글이 아니라 (형식 번호, 숫자들) 그대로 쌓으므로 시뮬레이션 스레드는 글자를 만들지 않는다.
+ * 링이 가득 차면 기록을 버리고 dropped 만 센다. */
+
+#define LOG_RING_SIZE 1024 // 2의 거듭제곱
+#define LOG_ARGS 5
+
+/* 기록 수준 */
+#define LOG_OFF 0
+#define LOG_INFO 1  // 점검, 재배정, 정원 초과
+#define LOG_DEBUG 2 // 배정할 때 엘리베이터마다 소요시간
+
+/* 형식 번호(logger.c 의 형식 문자열과 짝을 이룬다) */
+#define LOG_CANDIDATE 0    // 엘리베이터, 소요시간
+#define LOG_ASSIGN 1       // 엘리베이터, 현재 층, 목적 층, 사람 수
+#define LOG_MERGE 2        // 엘리베이터, 현재 층, 목적 층, 사람 수
+#define LOG_REBALANCE 3    // 원래 엘리베이터, 새 엘리베이터, 현재 층, 목적 층, 줄어든 시간
+#define LOG_MAINT 4        // 엘리베이터, 태운 사람 수
+#define LOG_MAINT_EARLY 5  // 엘리베이터, 태운 사람 수
+#define LOG_MAINT_FORCED 6 // 엘리베이터, 태운 사람 수
+#define LOG_MAINT_DEFER 7  // 엘리베이터, 태운 사람 수
+#define LOG_REPAIRED 8     // 엘리베이터
+#define LOG_FULL 9         // 엘리베이터, 층, 태운 사람 수, 남은 사람 수
+#define LOG_NUM_FORMATS 10
+
+typedef struct _LOGRECORD
+{
+    int32_t format;
+    int32_t building;
+    int32_t tick;
+    int32_t args[LOG_ARGS];
+} Log_record;
+
+typedef struct _LOGRING
+{
+    _Alignas(64) _Atomic uint32_t head; // 쓰는 쪽이 다음에 쓸 위치
+    _Alignas(64) _Atomic uint32_t tail; // 읽는 쪽이 다음에 읽을 위치
+    _Alignas(64) _Atomic int level;     // 이 수준 이하의 기록만 쌓는다
+    _Atomic uint32_t dropped;           // 링이 가득 차서 버린 기록 수
+    Log_record records[LOG_RING_SIZE];
+} Log_ring;
+
+static inline int log_enabled(Log_ring *ring, int level)
+{
+    return atomic_load_explicit(&ring->level, memory_order_relaxed) >= level;
+}
+
+static inline void log_push(Log_ring *ring, int level, int format, int building, int tick, int a0, int a1, int a2, int a3, int a4)
+{
+    uint32_t head;
+    Log_record *record;
+
+    // 수준이 꺼져 있으면 원자적 읽기 한 번으로 끝난다
+    if (!log_enabled(ring, level))
+    {
+        return;
+    }
+
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) == LOG_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    record = &ring->records[head & (LOG_RING_SIZE - 1)];
+    record->format = format;
+    record->building = building;
+    record->tick = tick;
+    record->args[0] = a0;
+    record->args[1] = a1;
+    record->args[2] = a2;
+    record->args[3] = a3;
+    record->args[4] = a4;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+/* 쌓인 기록 하나를 꺼낸다. 없으면 0 을 돌려준다(읽는 쪽 스레드 하나에서만). */
+static inline int log_pop(Log_ring *ring, Log_record *out)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    if (tail == atomic_load_explicit(&ring->head, memory_order_acquire))
+    {
+        return 0;
+    }
+    *out = ring->records[tail & (LOG_RING_SIZE - 1)];
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef ELEVATOR_SHM_H
+#define ELEVATOR_SHM_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/* 엘리베이터 시뮬레이션 상태 공유 메모리 레이아웃
+ * 시뮬레이션은 매 초 건물마다 상태를 SHM_NAME 공유 메모리에 기록한다.
+ * [Shm_header][Shm_building x num_buildings] 순서로 놓인다.
+ * 건물마다 기록 중에는 seq가 홀수이고, 기록이 끝나면 짝수가 된다(seqlock).
+ * 읽는 쪽은 shm_building_read 처럼 seq가 바뀌지 않았을 때만 읽은 값을 사용한다. */
+
+#define SHM_NAME "/elevator_state"
+#define SHM_VERSION 3
+#define SHM_ELEVATORS 6
+#define SHM_WAIT_BUCKETS 301 // 대기 시간 0~300초(300초 이상 포함)
+
+typedef struct _SHMELEVATOR
+{
+    int32_t current_floor;
+    int32_t direction;      // 1 : 위, -1 : 아래, 0 : 정지
+    int32_t next_dest;
+    int32_t current_people;
+    int32_t total_people;
+    int32_t fix;            // 1 : 수리 중
+    int32_t fix_remaining;  // 남은 수리 시간(초)
+    int32_t dwell;          // 남은 승하차 시간(초)
+    int32_t pending_stops;  // 대기 중인 정지 층 수
+} Shm_elevator;
+
+typedef struct _SHMHEADER
+{
+    uint32_t version;
+    int32_t num_buildings;
+    int32_t num_elevators;  // 건물마다 엘리베이터 수
+    int32_t reserved;
+} Shm_header;
+
+typedef struct _SHMBUILDING
+{
+    _Atomic uint32_t seq;
+    int32_t queue_depth;    // 배정을 기다리는 요청 수
+    int64_t tick;
+    Shm_elevator elevators[SHM_ELEVATORS];
+    int32_t maint_advanced;
+    int32_t maint_deferred;
+    int32_t maint_forced;
+    uint32_t wait_hist[SHM_WAIT_BUCKETS]; // 대기 시간별 승객 수
+    int32_t queue_peak;       // 가장 많이 쌓였던 요청 수
+    int32_t queue_delay_p95;  // 호출부터 배정까지 걸린 시간(초)
+    int32_t shed;             // 큐가 가득 차서 거절한 호출 수
+} Shm_building;
+
+static inline Shm_building *shm_building(Shm_header *header, int index)
+{
+    return (Shm_building *)(header + 1) + index;
+}
+
+/* 일관된 건물 상태 하나를 out에 읽어온다. 기록 중이면 끝날 때 까지 다시 시도한다. */
+static inline void shm_building_read(const Shm_building *state, Shm_building *out)
+{
+    uint32_t begin, end;
+
+    do
+    {
+        begin = atomic_load_explicit(&state->seq, memory_order_acquire);
+        memcpy((char *)out + sizeof(out->seq), (const char *)state + sizeof(state->seq), sizeof(*out) - sizeof(out->seq));
+        atomic_thread_fence(memory_order_acquire);
+        end = atomic_load_explicit(&state->seq, memory_order_relaxed);
+    } while ((begin & 1) || begin != end);
+
+    atomic_store_explicit(&out->seq, begin, memory_order_relaxed);
+}
+
+#endif
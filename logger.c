@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "logger.h"
+
+#define LOG_IDLE_USEC 10000 // 쌓인 기록이 없을 때 쉬는 시간
+
+/* 운행 일지 기록을 꺼내서 파일에 쓰는 스레드 */
+typedef struct _LOGGER
+{
+    FILE *file;
+    Log_ring **rings;   // 건물마다 하나
+    int num_rings;
+    int level;
+    volatile int quit;
+    uint32_t dropped;   // 이미 일지에 남긴 버린 기록 수
+    pthread_t thread;
+} Logger;
+
+void logger_write(Log_record *record);
+void logger_check_dropped(void);
+
+/* 전역 변수 */
+Logger logger;
+
+/* 형식 번호마다 형식 문자열(elevator_log.h 의 LOG_ 번호) */
+const char *log_formats[LOG_NUM_FORMATS] =
+{
+    [LOG_CANDIDATE] = "%d번째 엘리베이터 소요시간: %d초",
+    [LOG_ASSIGN] = "엘리베이터 %d 호출에 응답 (%dF -> %dF, %d명)",
+    [LOG_MERGE] = "엘리베이터 %d 의 같은 호출에 합침 (%dF -> %dF, %d명)",
+    [LOG_REBALANCE] = "엘리베이터 %d -> %d 로 옮김 (%dF -> %dF, %d초 빨라짐)",
+    [LOG_MAINT] = "엘리베이터 %d 점검 요청 (%d명 탑승)",
+    [LOG_MAINT_EARLY] = "엘리베이터 %d 점검 앞당김 (%d명 탑승)",
+    [LOG_MAINT_FORCED] = "엘리베이터 %d 강제 점검 (%d명 탑승)",
+    [LOG_MAINT_DEFER] = "엘리베이터 %d 점검 미룸 (%d명 탑승)",
+    [LOG_REPAIRED] = "엘리베이터 %d 점검 끝",
+    [LOG_FULL] = "엘리베이터 %d 정원 초과 (%dF, %d명 탑승, %d명 남음)",
+};
+
+int logger_start(const char *path, Log_ring **rings, int num_rings, int level)
+{
+    logger.file = fopen(path, "a");
+    if (logger.file == NULL)
+    {
+        return -1;
+    }
+    logger.rings = rings;
+    logger.num_rings = num_rings;
+    logger.quit = 0;
+    logger.dropped = 0;
+    logger_set_level(level);
+
+    if (pthread_create(&logger.thread, NULL, logger_f, NULL) != 0)
+    {
+        logger_set_level(LOG_OFF);
+        fclose(logger.file);
+        logger.file = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void *logger_f(void *data)
+{
+    Log_record record;
+    int written;
+    int quit;
+    int i;
+
+    // 1. 건물마다 쌓인 기록을 모두 꺼내 글로 바꿔 쓴다.
+    // 2. 쓴 기록이 없으면 잠시 쉰다.
+    // 종료할 때는 남은 기록을 다 쓰고 끝낸다.
+
+    while (1)
+    {
+        quit = logger.quit;
+        written = 0;
+        for (i = 0; i < logger.num_rings; i++)
+        {
+            while (log_pop(logger.rings[i], &record))
+            {
+                logger_write(&record);
+                written++;
+            }
+        }
+        if (written > 0)
+        {
+            logger_check_dropped();
+            fflush(logger.file);
+        }
+
+        if (quit)
+        {
+            break;
+        }
+        if (written == 0)
+        {
+            usleep(LOG_IDLE_USEC);
+        }
+    }
+    return NULL;
+}
+
+void logger_write(Log_record *record)
+{
+    if (record->format < 0 || record->format >= LOG_NUM_FORMATS)
+    {
+        return;
+    }
+    fprintf(logger.file, "[%7d초] 건물 %d | ", record->tick, record->building + 1);
+    fprintf(logger.file, log_formats[record->format], record->args[0], record->args[1], record->args[2], record->args[3], record->args[4]);
+    fprintf(logger.file, "\n");
+}
+
+void logger_check_dropped(void)
+{
+    uint32_t dropped = 0;
+    int i;
+
+    for (i = 0; i < logger.num_rings; i++)
+    {
+        dropped += atomic_load_explicit(&logger.rings[i]->dropped, memory_order_relaxed);
+    }
+    if (dropped != logger.dropped)
+    {
+        fprintf(logger.file, "기록이 밀려 %u개를 버림 \n", dropped - logger.dropped);
+        logger.dropped = dropped;
+    }
+}
+
+void logger_set_level(int level)
+{
+    int i;
+
+    // 시뮬레이션 스레드는 다음 기록부터 바뀐 수준을 본다
+    logger.level = level;
+    for (i = 0; i < logger.num_rings; i++)
+    {
+        atomic_store_explicit(&logger.rings[i]->level, level, memory_order_relaxed);
+    }
+}
+
+int logger_level(void)
+{
+    return logger.level;
+}
+
+void logger_stop(void)
+{
+    if (logger.file == NULL)
+    {
+        return;
+    }
+    logger.quit = 1;
+    pthread_join(logger.thread, NULL);
+    fclose(logger.file);
+    logger.file = NULL;
+}
@@ -0,0 +1,12 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "elevator_log.h"
+
+int logger_start(const char *path, Log_ring **rings, int num_rings, int level);
+void *logger_f(void *data);
+void logger_set_level(int level);
+int logger_level(void);
+void logger_stop(void);
+
+#endif
@@ -0,0 +1,594 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "server.h"
+
+#define MAX_CLIENTS 1024 // 동시에 접속 가능한 클라이언트 수(fd 기준)
+#define MAX_EVENTS 64
+#define TAG_FD_SHIFT 32  // 라이브러리에 넘기는 번호 : [세대 22비트][fd 10비트][호출 번호 32비트]
+#define TAG_GEN_SHIFT 42
+#define TAG_FD_MASK (MAX_CLIENTS - 1)
+#define TAG_GEN_MASK 0x3FFFFF
+#define PAUSE_MSEC 50    // 큐가 많이 쌓였을 때 클라이언트에서 읽기를 멈추는 시간
+
+typedef struct _ACK
+{
+    int client;
+    unsigned int gen;
+    Ack_msg msg;
+} Ack;
+
+typedef struct _CLIENT
+{
+    int fd;             // -1 : 비어있음
+    unsigned int gen;
+    int paused;         // 1 : 큐가 많이 쌓여서 읽기를 멈춤
+    char in[sizeof(uint32_t) + sizeof(Call_msg) * MAX_BATCH];
+    size_t in_len;
+    char *out;
+    size_t out_len;
+    size_t out_cap;
+} Client;
+
+typedef struct _SERVER
+{
+    Campus *campus;
+    const char *path;
+    int listen_fd;
+    int epoll_fd;
+    int ack_fd;         // 배정 결과가 쌓이거나 멈출 때 깨우는 eventfd
+    _Atomic int stopping; // 1 : server_f 를 끝낸다(server_stop)
+    unsigned int next_gen;
+    int num_paused;     // 읽기를 멈춘 클라이언트 수
+    long resume_at;     // 멈춘 클라이언트를 다시 읽을 시각(ms)
+    Client clients[MAX_CLIENTS];
+    pthread_mutex_t ack_lock;
+    Ack *acks;          // 시뮬레이션 스레드가 쌓은 배정 결과
+    int num_acks;
+    int ack_cap;
+} Server;
+
+void server_accept(void);
+void server_read(Client *client);
+int server_parse(Client *client);
+void server_pause(Client *client);
+void server_resume(void);
+long now_msec(void);
+void server_handle_batch(Client *client, Call_msg *msgs, uint32_t n);
+void server_submit(Client *client, Building *building, Sim_call *calls, uint32_t *tags, int n);
+void server_deliver_acks(void);
+void client_push_ack(Client *client, uint32_t tag, int elevator);
+void client_flush(Client *client);
+void client_watch(Client *client);
+void client_close(Client *client);
+
+/* 전역 변수 */
+Server server;
+
+int server_init(const char *path, Campus *campus)
+{
+    struct sockaddr_un addr;
+    struct epoll_event ev;
+    int i;
+
+    server.campus = campus;
+    server.path = path;
+    server.listen_fd = -1;
+    server.epoll_fd = -1;
+    server.ack_fd = -1;
+    atomic_init(&server.stopping, 0);
+    server.next_gen = 1;
+    server.num_paused = 0;
+    server.acks = NULL;
+    server.num_acks = 0;
+    server.ack_cap = 0;
+    pthread_mutex_init(&server.ack_lock, NULL);
+    for (i = 0; i < MAX_CLIENTS; i++)
+    {
+        server.clients[i].fd = -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    server.listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (server.listen_fd < 0)
+    {
+        return -1;
+    }
+    unlink(path);
+    if (bind(server.listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(server.listen_fd, SOMAXCONN) < 0)
+    {
+        close(server.listen_fd);
+        server.listen_fd = -1;
+        return -1;
+    }
+
+    server.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    server.ack_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (server.epoll_fd < 0 || server.ack_fd < 0)
+    {
+        close(server.listen_fd);
+        server.listen_fd = -1;
+        return -1;
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.fd = server.listen_fd;
+    epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &ev);
+    ev.events = EPOLLIN;
+    ev.data.fd = server.ack_fd;
+    epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, server.ack_fd, &ev);
+
+    return 0;
+}
+
+void *server_f(void *data)
+{
+    struct epoll_event events[MAX_EVENTS];
+    Client *client;
+    int n, i, fd;
+
+    // 1. 새 연결을 받는다.
+    // 2. 클라이언트가 보낸 프레임을 읽어 요청 큐에 넣는다.
+    // 2-1. 큐가 많이 쌓였으면 그 클라이언트는 잠시 읽지 않는다.
+    // 3. 시뮬레이션 스레드가 배정을 끝내면 클라이언트에 응답한다.
+    // server_stop 이 깨우면 끝낸다(그 뒤로는 건물에 호출을 넣지 않는다).
+
+    while (!atomic_load(&server.stopping))
+    {
+        if (server.num_paused > 0 && now_msec() >= server.resume_at)
+        {
+            server_resume();
+        }
+        n = epoll_wait(server.epoll_fd, events, MAX_EVENTS, server.num_paused > 0 ? PAUSE_MSEC : -1);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            fd = events[i].data.fd;
+            if (fd == server.listen_fd)
+            {
+                server_accept();
+                continue;
+            }
+            if (fd == server.ack_fd)
+            {
+                server_deliver_acks();
+                if (atomic_load(&server.stopping))
+                {
+                    break;
+                }
+                continue;
+            }
+
+            client = &server.clients[fd];
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                client_close(client);
+                continue;
+            }
+            if (events[i].events & EPOLLIN)
+            {
+                server_read(client);
+            }
+            if (client->fd >= 0 && (events[i].events & EPOLLOUT))
+            {
+                client_flush(client);
+            }
+        }
+    }
+    return NULL;
+}
+
+void server_accept(void)
+{
+    struct epoll_event ev;
+    Client *client;
+    int fd;
+
+    while (1)
+    {
+        fd = accept4(server.listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+        if (fd >= MAX_CLIENTS)
+        {
+            close(fd);
+            continue;
+        }
+
+        client = &server.clients[fd];
+        client->fd = fd;
+        client->gen = server.next_gen++;
+        client->paused = 0;
+        client->in_len = 0;
+        client->out = NULL;
+        client->out_len = 0;
+        client->out_cap = 0;
+
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+void server_read(Client *client)
+{
+    ssize_t len;
+
+    // 버퍼에 남은 프레임을 먼저 처리하고(다시 읽기 시작할 때), 멈추라는 신호가 올 때 까지 읽는다
+    while (1)
+    {
+        if (!server_parse(client))
+        {
+            return;
+        }
+        if (client->paused)
+        {
+            break;
+        }
+
+        len = read(client->fd, client->in + client->in_len, sizeof(client->in) - client->in_len);
+        if (len == 0 || (len < 0 && errno != EAGAIN && errno != EINTR))
+        {
+            client_close(client);
+            return;
+        }
+        if (len < 0)
+        {
+            break;
+        }
+        client->in_len += len;
+    }
+
+    client_flush(client);
+}
+
+int server_parse(Client *client)
+{
+    uint32_t n;
+    size_t need;
+    size_t used = 0;
+
+    // 완성된 프레임을 처리한다. 잘못된 프레임이면 연결을 끊고 0 을 돌려준다.
+    while (!client->paused && client->in_len - used >= sizeof(uint32_t))
+    {
+        memcpy(&n, client->in + used, sizeof(uint32_t));
+        if (n > MAX_BATCH)
+        {
+            client_close(client);
+            return 0;
+        }
+        need = sizeof(uint32_t) + sizeof(Call_msg) * n;
+        if (client->in_len - used < need)
+        {
+            break;
+        }
+        server_handle_batch(client, (Call_msg *)(client->in + used + sizeof(uint32_t)), n);
+        used += need;
+    }
+    memmove(client->in, client->in + used, client->in_len - used);
+    client->in_len -= used;
+    return 1;
+}
+
+void server_pause(Client *client)
+{
+    // 호출 프레임을 더 읽지 않으면 소켓 버퍼가 차서 클라이언트의 쓰기가 막힌다
+    if (client->paused)
+    {
+        return;
+    }
+    client->paused = 1;
+    if (server.num_paused++ == 0)
+    {
+        server.resume_at = now_msec() + PAUSE_MSEC;
+    }
+}
+
+void server_resume(void)
+{
+    Client *client;
+    int i;
+
+    server.num_paused = 0;
+    for (i = 0; i < MAX_CLIENTS; i++)
+    {
+        client = &server.clients[i];
+        if (client->fd >= 0 && client->paused)
+        {
+            client->paused = 0;
+            server_read(client);
+        }
+    }
+}
+
+long now_msec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000L + ts.tv_nsec / 1000000;
+}
+
+void server_handle_batch(Client *client, Call_msg *msgs, uint32_t n)
+{
+    Campus *campus = server.campus;
+    Building *building = NULL; // 모으고 있는 호출의 건물
+    Sim_call calls[MAX_BATCH];
+    uint32_t tags[MAX_BATCH];
+    Call_msg msg;
+    int num_calls = 0;
+    uint32_t i;
+
+    // 같은 건물로 가는 호출이 이어지면 모아서 잠금을 한 번만 잡는다
+    for (i = 0; i < n; i++)
+    {
+        memcpy(&msg, &msgs[i], sizeof(msg));
+        if (msg.building < 0 || msg.building >= campus->num_buildings)
+        {
+            client_push_ack(client, msg.tag, 0);
+            continue;
+        }
+
+        if (campus->buildings[msg.building] != building)
+        {
+            server_submit(client, building, calls, tags, num_calls);
+            building = campus->buildings[msg.building];
+            num_calls = 0;
+        }
+
+        calls[num_calls].start_floor = msg.start_floor;
+        calls[num_calls].dest_floor = msg.dest_floor;
+        calls[num_calls].num_people = msg.num_people;
+        calls[num_calls].tag = ((uint64_t)(client->gen & TAG_GEN_MASK) << TAG_GEN_SHIFT) | ((uint64_t)client->fd << TAG_FD_SHIFT) | msg.tag;
+        tags[num_calls] = msg.tag;
+        num_calls++;
+    }
+    server_submit(client, building, calls, tags, num_calls);
+}
+
+void server_submit(Client *client, Building *building, Sim_call *calls, uint32_t *tags, int n)
+{
+    int status[MAX_BATCH];
+    int i;
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    // 잘못된 호출은 바로 0으로, 큐가 가득 차서 거절된 호출은 바로 ACK_SHED 로 응답한다.
+    // 큐가 많이 쌓였으면 이 클라이언트에서 잠시 읽지 않는다.
+    sim_submit_batch(building, calls, n, status, NULL);
+    for (i = 0; i < n; i++)
+    {
+        if (status[i] == SIM_INVALID)
+        {
+            client_push_ack(client, tags[i], 0);
+        }
+        else if (status[i] == SIM_SHED)
+        {
+            client_push_ack(client, tags[i], ACK_SHED);
+            server_pause(client);
+        }
+        else if (status[i] == SIM_BUSY)
+        {
+            server_pause(client);
+        }
+    }
+}
+
+void server_assign(void *ctx, const uint64_t *tags, int num_tags, int elevator)
+{
+    uint64_t one = 1;
+    Ack *ack;
+    int i;
+
+    // 시뮬레이션 스레드에서 불린다. 응답은 소켓 스레드가 보낸다.
+
+    if (server.ack_fd < 0)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&server.ack_lock);
+    for (i = 0; i < num_tags; i++)
+    {
+        if (server.num_acks == server.ack_cap)
+        {
+            server.ack_cap = server.ack_cap ? server.ack_cap * 2 : 64;
+            server.acks = (Ack *)realloc(server.acks, sizeof(Ack) * server.ack_cap);
+        }
+        ack = &server.acks[server.num_acks++];
+        ack->client = (tags[i] >> TAG_FD_SHIFT) & TAG_FD_MASK;
+        ack->gen = (tags[i] >> TAG_GEN_SHIFT) & TAG_GEN_MASK;
+        ack->msg.tag = (uint32_t)tags[i];
+        ack->msg.elevator = elevator + 1;
+    }
+    pthread_mutex_unlock(&server.ack_lock);
+
+    write(server.ack_fd, &one, sizeof(one));
+}
+
+void server_stop(void)
+{
+    uint64_t one = 1;
+
+    // server_f 를 깨워서 끝내게 한다. 부른 쪽은 server_f 스레드가 끝날 때 까지 기다린 뒤 server_close 를 부른다.
+    atomic_store(&server.stopping, 1);
+    if (server.ack_fd >= 0)
+    {
+        write(server.ack_fd, &one, sizeof(one));
+    }
+}
+
+void server_close(void)
+{
+    int i;
+
+    // server_f 가 끝난 뒤에(또는 시작하지 않았으면) 부른다
+    for (i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (server.clients[i].fd >= 0)
+        {
+            client_close(&server.clients[i]);
+        }
+    }
+    if (server.path != NULL && server.listen_fd >= 0)
+    {
+        unlink(server.path);
+    }
+    if (server.listen_fd >= 0)
+    {
+        close(server.listen_fd);
+        server.listen_fd = -1;
+    }
+    if (server.epoll_fd >= 0)
+    {
+        close(server.epoll_fd);
+        server.epoll_fd = -1;
+    }
+    if (server.ack_fd >= 0)
+    {
+        close(server.ack_fd);
+        server.ack_fd = -1;
+    }
+    free(server.acks);
+    server.acks = NULL;
+    server.num_acks = 0;
+    server.ack_cap = 0;
+}
+
+void server_deliver_acks(void)
+{
+    uint64_t count;
+    Ack *acks;
+    Client *client;
+    int num_acks;
+    int i;
+
+    read(server.ack_fd, &count, sizeof(count));
+
+    // 쌓인 응답을 통째로 가져와서 잠금 시간을 줄인다
+    pthread_mutex_lock(&server.ack_lock);
+    acks = server.acks;
+    num_acks = server.num_acks;
+    server.acks = NULL;
+    server.num_acks = 0;
+    server.ack_cap = 0;
+    pthread_mutex_unlock(&server.ack_lock);
+
+    for (i = 0; i < num_acks; i++)
+    {
+        client = &server.clients[acks[i].client];
+        // 이미 끊긴 클라이언트의 응답은 버린다
+        if (client->fd < 0 || (client->gen & TAG_GEN_MASK) != acks[i].gen)
+        {
+            continue;
+        }
+        client_push_ack(client, acks[i].msg.tag, acks[i].msg.elevator);
+    }
+
+    for (i = 0; i < num_acks; i++)
+    {
+        client = &server.clients[acks[i].client];
+        if (client->fd >= 0 && (client->gen & TAG_GEN_MASK) == acks[i].gen && client->out_len > 0)
+        {
+            client_flush(client);
+        }
+    }
+    free(acks);
+}
+
+void client_push_ack(Client *client, uint32_t tag, int elevator)
+{
+    Ack_msg msg;
+
+    if (client->out_len + sizeof(msg) > client->out_cap)
+    {
+        client->out_cap = client->out_cap ? client->out_cap * 2 : sizeof(msg) * 256;
+        client->out = (char *)realloc(client->out, client->out_cap);
+    }
+    msg.tag = tag;
+    msg.elevator = elevator;
+    memcpy(client->out + client->out_len, &msg, sizeof(msg));
+    client->out_len += sizeof(msg);
+}
+
+void client_flush(Client *client)
+{
+    size_t sent = 0;
+    ssize_t len;
+
+    while (sent < client->out_len)
+    {
+        len = write(client->fd, client->out + sent, client->out_len - sent);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN)
+            {
+                client_close(client);
+                return;
+            }
+            break;
+        }
+        sent += len;
+    }
+    memmove(client->out, client->out + sent, client->out_len - sent);
+    client->out_len -= sent;
+
+    client_watch(client);
+}
+
+void client_watch(Client *client)
+{
+    struct epoll_event ev;
+
+    // 다 못 보냈으면 보낼 수 있을 때 다시 깨우고, 읽기를 멈췄으면 읽을 거리가 있어도 깨우지 않는다
+    ev.events = (client->paused ? 0 : EPOLLIN) | (client->out_len > 0 ? EPOLLOUT : 0);
+    ev.data.fd = client->fd;
+    epoll_ctl(server.epoll_fd, EPOLL_CTL_MOD, client->fd, &ev);
+}
+
+void client_close(Client *client)
+{
+    epoll_ctl(server.epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    free(client->out);
+    client->out = NULL;
+    client->out_len = 0;
+    client->out_cap = 0;
+    client->in_len = 0;
+    client->fd = -1;
+    if (client->paused)
+    {
+        client->paused = 0;
+        server.num_paused--;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdint.h>
+#include "campus.h"
+
+#define MAX_BATCH 1024 // 한 프레임에 담을 수 있는 호출 수
+
+/* 소켓 프로토콜
+ * 호출 프레임 : [uint32_t 개수][Call_msg x 개수]
+ * 응답 : 호출마다 Ack_msg 하나, 배정된 엘리베이터 번호(1~6), 거부된 호출은 0,
+ *        큐가 가득 차서 거절된 호출은 ACK_SHED(나중에 다시 보내야 한다)
+ *        더 빨리 태울 수 있는 엘리베이터로 옮기면 같은 호출 번호로 응답을 한 번 더 보낸다
+ * 큐가 많이 쌓이면 서버가 잠시 읽기를 멈추므로 클라이언트의 쓰기가 막힐 수 있다. */
+#define ACK_SHED -1
+typedef struct _CALLMSG
+{
+    int32_t building;
+    int32_t start_floor;
+    int32_t dest_floor;
+    int32_t num_people;
+    uint32_t tag;
+} Call_msg;
+
+typedef struct _ACKMSG
+{
+    uint32_t tag;
+    int32_t elevator;
+} Ack_msg;
+
+int server_init(const char *path, Campus *campus);
+void *server_f(void *data);
+void server_assign(void *ctx, const uint64_t *tags, int num_tags, int elevator);
+void server_stop(void);  // server_f 를 끝낸다(스레드는 부른 쪽이 기다린다)
+void server_close(void); // 소켓을 닫는다(server_f 가 끝난 뒤에)
+
+#endif
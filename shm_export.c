@@ -0,0 +1,116 @@
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include "elevator_shm.h"
+#include "shm_export.h"
+
+/* 전역 변수 */
+Shm_header *shm_header = NULL; // 외부 도구에 공개하는 상태(공유 메모리)
+size_t shm_size = 0;
+
+int shm_init(int num_buildings)
+{
+    int fd;
+    void *addr;
+    size_t size;
+
+    size = sizeof(Shm_header) + sizeof(Shm_building) * num_buildings;
+    fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if (ftruncate(fd, size) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    memset(addr, 0, size);
+    shm_header = (Shm_header *)addr;
+    shm_size = size;
+    shm_header->version = SHM_VERSION;
+    shm_header->num_buildings = num_buildings;
+    shm_header->num_elevators = SIM_ELEVATORS;
+    return 0;
+}
+
+void shm_publish(void *ctx, Building *building, const Sim_snapshot *snapshot)
+{
+    const Sim_car *cars = snapshot->cars;
+    const Sim_stats *stats = &snapshot->stats;
+    Shm_building *state;
+    Shm_elevator *out;
+    uint32_t seq;
+    int i;
+
+    // 진행한 스레드가 방금 내보낸 상태를 옮기므로 시뮬레이션 잠금이 필요 없다.
+    // 건물마다 쓰는 스레드가 하나뿐이라 잠금 없이 seq만 올린다.
+    // 읽는 쪽은 seq를 보고 다시 읽으므로 시뮬레이션을 기다리게 하지 않는다.
+
+    if (shm_header == NULL)
+    {
+        return;
+    }
+    state = shm_building(shm_header, stats->id);
+
+    seq = atomic_load_explicit(&state->seq, memory_order_relaxed);
+    atomic_store_explicit(&state->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    state->tick = stats->ticks;
+    state->queue_depth = stats->queue_depth;
+    for (i = 0; i < SIM_ELEVATORS; i++)
+    {
+        out = &state->elevators[i];
+        out->current_floor = cars[i].current_floor;
+        out->next_dest = cars[i].next_dest;
+        if (cars[i].next_dest > cars[i].current_floor)
+        {
+            out->direction = 1;
+        }
+        else if (cars[i].next_dest < cars[i].current_floor)
+        {
+            out->direction = -1;
+        }
+        else
+        {
+            out->direction = 0;
+        }
+        out->current_people = cars[i].current_people;
+        out->total_people = cars[i].total_people;
+        out->fix = cars[i].fix;
+        out->fix_remaining = cars[i].fix_remaining;
+        out->dwell = cars[i].dwell;
+        out->pending_stops = cars[i].num_stops;
+    }
+    state->maint_advanced = stats->maint_advanced;
+    state->maint_deferred = stats->maint_deferred;
+    state->maint_forced = stats->maint_forced;
+    state->queue_peak = stats->queue_peak;
+    state->queue_delay_p95 = stats->queue_delay_p95;
+    state->shed = stats->shed;
+    for (i = 0; i < SHM_WAIT_BUCKETS && i <= SIM_MAX_WAIT; i++)
+    {
+        state->wait_hist[i] = stats->wait_hist[i];
+    }
+
+    atomic_store_explicit(&state->seq, seq + 2, memory_order_release);
+}
+
+void shm_close(void)
+{
+    if (shm_header != NULL)
+    {
+        munmap(shm_header, shm_size);
+        shm_unlink(SHM_NAME);
+        shm_header = NULL;
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef SHM_EXPORT_H
+#define SHM_EXPORT_H
+
+#include "elevator.h"
+
+int shm_init(int num_buildings);
+void shm_publish(void *ctx, Building *building, const Sim_snapshot *snapshot);
+void shm_close(void);
+
+#endif
@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/* 시뮬레이션 코어 검사(make test)
+ * 타이머 바퀴와 엘리베이터의 정지 층, 호출 목록을 직접 보기 위해 elevator_core.c 를 그대로 포함한다. */
+#include "elevator_core.c"
+
+#define WHEEL_TEST_TIMERS 36000
+#define WHEEL_TEST_TICKS 300000 // 64^3 보다 길어서 맨 위 단계까지 쓴다
+#define LOAD_TEST_TICKS 60000
+#define LOAD_TEST_IDS 4096 // 취소할 수 있도록 기억해두는 호출 번호 수
+
+int failures = 0;
+
+void check(int ok, const char *what, int tick, int value)
+{
+    if (!ok && failures++ < 10)
+    {
+        printf("실패 : %s (%d초, %d)\n", what, tick, value);
+    }
+}
+
+void test_wheel(void)
+{
+    Building *building = sim_create(&(Sim_config){0});
+    Timer *timers = (Timer *)calloc(WHEEL_TEST_TIMERS, sizeof(Timer));
+    int *due = (int *)malloc(sizeof(int) * (WHEEL_TEST_TICKS + 2));   // 끝나는 시각별 타이머 목록의 처음
+    int *start = (int *)malloc(sizeof(int) * (WHEEL_TEST_TICKS + 2)); // 거는 시각별 타이머 목록의 처음
+    int *next_due = (int *)malloc(sizeof(int) * WHEEL_TEST_TIMERS);
+    int *next_start = (int *)malloc(sizeof(int) * WHEEL_TEST_TIMERS);
+    int i, t;
+
+    // 1. 절반은 처음에, 나머지는 도중에 임의의 시각으로 건다.
+    // 2. 1초씩 진행하면서 끝나는 시각이 된 타이머는 모두 끝났는지,
+    //    다음 1초에 끝날 타이머는 아직 걸려 있는지(일찍 끝나지 않았는지) 본다.
+
+    srand(1);
+    for (t = 0; t < WHEEL_TEST_TICKS + 2; t++)
+    {
+        due[t] = -1;
+        start[t] = -1;
+    }
+    for (i = 0; i < WHEEL_TEST_TIMERS; i++)
+    {
+        timers[i].owner = 0;
+        timers[i].expires = 1 + rand() % WHEEL_TEST_TICKS;
+        t = i % 2 == 0 || timers[i].expires < 2 ? 0 : rand() % (timers[i].expires - 1); // 끝나기 1초 전까지는 걸려 있어야 검사할 수 있다
+        next_due[i] = due[timers[i].expires];
+        due[timers[i].expires] = i;
+        next_start[i] = start[t];
+        start[t] = i;
+    }
+
+    for (t = 1; t <= WHEEL_TEST_TICKS; t++)
+    {
+        for (i = start[t - 1]; i >= 0; i = next_start[i])
+        {
+            timer_add(&building->wheel, &timers[i], 0, timers[i].expires);
+        }
+        wheel_advance(building);
+        for (i = due[t]; i >= 0; i = next_due[i])
+        {
+            check(timers[i].next == NULL, "타이머가 끝나지 않음", t, i);
+        }
+        for (i = due[t + 1]; i >= 0; i = next_due[i])
+        {
+            check(timers[i].next != NULL, "타이머가 일찍 끝남", t, i);
+        }
+    }
+
+    free(next_start);
+    free(next_due);
+    free(start);
+    free(due);
+    free(timers);
+    sim_destroy(building);
+}
+
+int check_queue(Building *building, R_list *list, int *num_calls)
+{
+    R_node *node;
+    Call *call;
+    int people;
+    int count = 0;
+
+    for (node = list->head->next; node != list->tail; node = node->next)
+    {
+        count++;
+        people = 0;
+        for (call = node->req.calls; call != NULL; call = call->next)
+        {
+            check(call->state == CALL_QUEUED && call->queued == node, "호출이 큐의 요청을 가리키지 않음", building->ticks, node->req.start_floor);
+            people += call->people;
+            (*num_calls)++;
+        }
+        check(people == node->req.num_people, "큐의 요청과 호출 목록의 사람 수가 다름", building->ticks, node->req.start_floor);
+    }
+    return count;
+}
+
+void check_building(Building *building)
+{
+    Elevator *elevator;
+    F_node *curr;
+    Call *call;
+    int load;   // 탄 사람 수 + 정지 층에서 태우고 내릴 사람 수
+    int people;
+    int cursor; // 재배정 검사를 이어서 할 정지 층이 목록에 있는지
+    int queued = 0;
+    int num_calls = 0; // 큐와 정지 층에 매달린 호출 수
+    int i, r;
+
+    // 1. 엘리베이터마다 탄 사람과 앞으로 태우고 내릴 사람을 더하면 0 이다.
+    // 2. 태우는 층의 사람 수는 호출 목록의 사람 수를 더한 것과 같고, 짝인 내리는 층과 맞는다.
+    // 3. 재배정 검사를 이어서 할 정지 층은 그 엘리베이터의 목록에 있다.
+    // 4. 큐의 요청도 호출 목록과 맞고, 요청 수는 queue_size 와 같다.
+    // 5. 태우지 않은 호출 수(num_calls)는 큐와 정지 층에 매달린 호출 수와 같고 queue_capacity 를 넘지 않는다.
+
+    for (i = 0; i < NUM_ELEVATORS; i++)
+    {
+        elevator = building->elevators[i];
+        load = elevator->current_people;
+        cursor = elevator->rebalance_at == NULL || elevator->rebalance_at == elevator->pending.tail;
+        check(load >= 0 && load <= MAX_PEOPLE, "탄 사람 수가 정원을 벗어남", building->ticks, load);
+        for (curr = elevator->pending.head->next; curr != elevator->pending.tail; curr = curr->next)
+        {
+            load += curr->people;
+            cursor |= curr == elevator->rebalance_at;
+            if (curr->people <= 0)
+            {
+                continue;
+            }
+            check(curr->pair != NULL && curr->pair->pair == curr, "태우는 층의 짝이 없음", building->ticks, i);
+            if (curr->pair != NULL)
+            {
+                check(curr->pair->people == -curr->people, "짝인 내리는 층의 사람 수가 다름", building->ticks, i);
+            }
+            people = 0;
+            for (call = curr->calls; call != NULL; call = call->next)
+            {
+                check(call->state == CALL_ASSIGNED && call->pickup == curr, "호출이 태우는 층을 가리키지 않음", building->ticks, i);
+                people += call->people;
+                num_calls++;
+            }
+            check(people == curr->people, "태우는 층과 호출 목록의 사람 수가 다름", building->ticks, i);
+        }
+        check(load == 0, "탄 사람과 정지 층의 사람 수가 맞지 않음", building->ticks, load);
+        check(cursor, "재배정 검사 위치가 목록에 없음", building->ticks, i);
+    }
+
+    for (r = 0; r < NUM_ROUTES; r++)
+    {
+        queued += check_queue(building, &building->reqs[r], &num_calls);
+        queued += check_queue(building, &building->retries[r], &num_calls);
+    }
+    check(queued == building->queue_size, "큐의 요청 수가 queue_size 와 다름", building->ticks, queued);
+    check(num_calls == building->num_calls, "태우지 않은 호출 수가 num_calls 와 다름", building->ticks, num_calls);
+    check(num_calls <= building->queue_capacity, "태우지 않은 호출 수가 queue_capacity 를 넘음", building->ticks, num_calls);
+}
+
+void test_ids(void)
+{
+    Building *building = sim_create(&(Sim_config){0});
+    Sim_call call = {1, 5, 1, 0};
+    Sim_id old_id, id;
+    int i;
+
+    // 놓아준 호출의 번호는 칸을 여러 번 다시 써도 돌아오지 않고, 옛 번호로 다른 호출을 지우지 못한다
+
+    sim_submit(building, &call, &old_id);
+    sim_cancel(building, old_id);
+    for (i = 0; i < 5000; i++)
+    {
+        sim_submit(building, &call, &id);
+        check(id != old_id, "놓아준 호출 번호가 다시 나옴", building->ticks, i);
+        check(sim_cancel(building, old_id) == SIM_INVALID, "옛 호출 번호로 다른 호출을 지움", building->ticks, i);
+        sim_cancel(building, id);
+    }
+
+    sim_destroy(building);
+}
+
+void test_load(void)
+{
+    Building *building = sim_create(&(Sim_config){0});
+    Sim_id ids[LOAD_TEST_IDS];
+    Sim_call call;
+    int num_ids = 0;
+    int load;   // 이 값 분의 1 확률로 1초마다 호출한다
+    int t;
+
+    // 한가할 때부터 큐가 넘칠 때까지 부하를 바꾸며 호출하고, 가끔 취소하고, 중간에 재시작한다.
+    // 1초마다 check_building 으로 사람 수가 어긋나지 않는지 본다.
+
+    srand(2);
+    for (t = 0; t < LOAD_TEST_TICKS; t++)
+    {
+        load = t % 20000 < 10000 ? 8 : 2;
+        if (rand() % load == 0)
+        {
+            call.start_floor = rand() % FLOOR + 1;
+            call.dest_floor = rand() % FLOOR + 1;
+            call.num_people = rand() % 4 + 1;
+            call.tag = t + 1;
+            if (sim_submit(building, &call, &ids[num_ids % LOAD_TEST_IDS]) >= 0)
+            {
+                num_ids++;
+            }
+        }
+        if (num_ids > 0 && rand() % 5 == 0)
+        {
+            sim_cancel(building, ids[rand() % (num_ids < LOAD_TEST_IDS ? num_ids : LOAD_TEST_IDS)]);
+        }
+        if (t == LOAD_TEST_TICKS / 2)
+        {
+            sim_reset(building);
+        }
+        sim_step(building, 1);
+        check_building(building);
+    }
+
+    sim_destroy(building);
+}
+
+int main(void)
+{
+    test_wheel();
+    test_ids();
+    test_load();
+    if (failures > 0)
+    {
+        printf("검사 실패 %d건 \n", failures);
+        return 1;
+    }
+    printf("검사 통과 \n");
+    return 0;
+}